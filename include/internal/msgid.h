@@ -126,6 +126,21 @@
 #define MSGID_NYX_MOD_TP_TOOMANY_ITEMS_ERR                                  "NYXTP_TOOMANY_ITEMS_ERR"
 #define MSGID_NYX_MOD_TP_OUT_OF_MEMORY                                      "NYXTP_OUT_OF_MEM_ERR"
 #define MSGID_NYX_MOD_TP_IGNORING_COORD                                     "NYXTP_IGNORING_COORD"
+#define MSGID_NYX_MOD_TP_READ_STATS                                         "NYXTP_READ_STATS"
+#define MSGID_NYX_MOD_TP_EVENT_POOL_EXHAUSTED                               "NYXTP_EVENT_POOL_EXHAUSTED"
+#define MSGID_NYX_MOD_TP_LATENCY                                            "NYXTP_LATENCY"
+#define MSGID_NYX_MOD_TP_SYN_DROPPED                                        "NYXTP_SYN_DROPPED"
+#define MSGID_NYX_MOD_TP_RESYNC_ERR                                         "NYXTP_RESYNC_ERR"
+#define MSGID_NYX_MOD_TP_SLOTS                                              "NYXTP_SLOTS"
+#define MSGID_NYX_MOD_TP_EVENT_OVERFLOW                                     "NYXTP_EVENT_OVERFLOW"
+#define MSGID_NYX_MOD_TP_COALESCED                                          "NYXTP_COALESCED"
+#define MSGID_NYX_MOD_TP_READER                                             "NYXTP_READER"
+#define MSGID_NYX_MOD_TP_CLOCK                                              "NYXTP_CLOCK"
+#define MSGID_NYX_MOD_TP_SCAN_RATE                                          "NYXTP_SCAN_RATE"
+#define MSGID_NYX_MOD_TP_PALM                                               "NYXTP_PALM"
+#define MSGID_NYX_MOD_TP_DELTA_FRAMES                                       "NYXTP_DELTA_FRAMES"
+#define MSGID_NYX_MOD_TP_CALIBRATION                                        "NYXTP_CALIBRATION"
+#define MSGID_NYX_MOD_TP_INPUTS                                             "NYXTP_INPUTS"
 /**Touchpanel mtdev*/
 #define MSGID_NYX_QMUX_TP_COORDBUF_ERR         "NYXTP_COORDBUF_ERR"
 #define MSGID_NYX_QMUX_TP_COORDS_ERR           "NYXTP_COORDS_ERR"
@@ -0,0 +1,180 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/*
+ * Extensions of the touchpanel modules beyond the nyx touchpanel API.
+ *
+ * nyx-lib only dispatches its own set of touchpanel methods, so clients
+ * resolve these from the module nyx-lib loaded, without loading it again:
+ *
+ *   void *module = dlopen(modulePath, RTLD_NOW | RTLD_NOLOAD);
+ *   touchpanel_get_latency_function_t get_latency =
+ *       (touchpanel_get_latency_function_t) dlsym(module,
+ *               TOUCHPANEL_GET_LATENCY_METHOD);
+ *
+ * The device passed is the handle nyx_device_open() returned, events are
+ * those nyx_device_get_event() returned. A symbol the loaded module does not
+ * provide is simply not supported by it.
+ */
+
+#ifndef __NYX_MODULES_TOUCHPANEL_H
+#define __NYX_MODULES_TOUCHPANEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nyx/nyx_module.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Latency of the touch frames since the module was opened, in ns. Both
+ * touchpanel modules provide it.
+ */
+typedef enum
+{
+	TOUCHPANEL_LATENCY_KERNEL_TO_SYN = 0,   /**< kernel timestamp to EV_SYN processed */
+	TOUCHPANEL_LATENCY_SYN_TO_RETURN,       /**< EV_SYN processed to event returned */
+	TOUCHPANEL_LATENCY_KERNEL_TO_RETURN,    /**< whole path */
+	TOUCHPANEL_LATENCY_NUM_STAGES
+} touchpanel_latency_stage_t;
+
+#define TOUCHPANEL_GET_LATENCY_METHOD   "touchpanel_get_latency"
+#define TOUCHPANEL_DUMP_LATENCY_METHOD  "touchpanel_dump_latency"
+
+/* Median, 99th percentile and maximum of a stage, 0 before the first frame */
+nyx_error_t touchpanel_get_latency(nyx_device_t *d, int stage, uint64_t *p50,
+                                   uint64_t *p99, uint64_t *max);
+/* Log the percentiles of every stage, as done when the module is closed */
+nyx_error_t touchpanel_dump_latency(nyx_device_t *d);
+
+typedef nyx_error_t (*touchpanel_get_latency_function_t)(nyx_device_t *d,
+        int stage, uint64_t *p50, uint64_t *p99, uint64_t *max);
+typedef nyx_error_t (*touchpanel_dump_latency_function_t)(nyx_device_t *d);
+
+/*
+ * Display refresh the touchpanel_mtdev module aligns resampled positions
+ * with, see the resample setting. Timestamp and period are in ns; the
+ * timestamp is of any past refresh, on CLOCK_MONOTONIC unless the kernel
+ * refused to switch the touch events to it. A period of 0 falls back to the
+ * vsyncPeriod setting.
+ */
+#define TOUCHPANEL_SET_VSYNC_METHOD     "touchpanel_set_vsync"
+
+nyx_error_t touchpanel_set_vsync(nyx_device_t *d, int64_t timestamp,
+                                 int64_t period);
+
+typedef nyx_error_t (*touchpanel_set_vsync_function_t)(nyx_device_t *d,
+        int64_t timestamp, int64_t period);
+
+/*
+ * Times the kernel dropped touchpanel events (SYN_DROPPED) and times the
+ * device state was read back afterwards, touchpanel_mtdev only. Either
+ * pointer may be NULL.
+ */
+#define TOUCHPANEL_GET_DROP_STATS_METHOD    "touchpanel_get_drop_stats"
+
+nyx_error_t touchpanel_get_drop_stats(nyx_device_t *d, unsigned long *drops,
+                                      unsigned long *resyncs);
+
+typedef nyx_error_t (*touchpanel_get_drop_stats_function_t)(nyx_device_t *d,
+        unsigned long *drops, unsigned long *resyncs);
+
+/*
+ * Collapsing the moves queued for a finger between two reads to the latest
+ * one, touchpanel_mtdev only; downs and ups are always delivered. It starts
+ * as the coalesce setting, the count is of the moves dropped so far.
+ */
+#define TOUCHPANEL_SET_COALESCING_METHOD    "touchpanel_set_coalescing"
+#define TOUCHPANEL_GET_COALESCED_METHOD     "touchpanel_get_coalesced"
+
+nyx_error_t touchpanel_set_coalescing(nyx_device_t *d, bool enable);
+nyx_error_t touchpanel_get_coalesced(nyx_device_t *d, unsigned long *merged);
+
+typedef nyx_error_t (*touchpanel_set_coalescing_function_t)(nyx_device_t *d,
+        bool enable);
+typedef nyx_error_t (*touchpanel_get_coalesced_function_t)(nyx_device_t *d,
+        unsigned long *merged);
+
+/*
+ * Delta frames, touchpanel_mtdev only: fingers that neither went down, moved
+ * nor lifted since they were last reported get an item with only their
+ * finger id, and the client keeps their last reported position. It starts
+ * as the deltaFrames setting; the count is of the items reduced so far.
+ */
+#define TOUCHPANEL_SET_DELTA_FRAMES_METHOD      "touchpanel_set_delta_frames"
+#define TOUCHPANEL_IS_CONTACT_UNCHANGED_METHOD  "touchpanel_is_contact_unchanged"
+#define TOUCHPANEL_GET_SUPPRESSED_METHOD        "touchpanel_get_suppressed"
+
+nyx_error_t touchpanel_set_delta_frames(nyx_device_t *d, bool enable);
+nyx_error_t touchpanel_is_contact_unchanged(nyx_device_t *d, nyx_event_t *e,
+        int item, bool *unchanged);
+nyx_error_t touchpanel_get_suppressed(nyx_device_t *d,
+                                      unsigned long *suppressed);
+
+typedef nyx_error_t (*touchpanel_set_delta_frames_function_t)(nyx_device_t *d,
+        bool enable);
+typedef nyx_error_t (*touchpanel_is_contact_unchanged_function_t)(
+    nyx_device_t *d, nyx_event_t *e, int item, bool *unchanged);
+typedef nyx_error_t (*touchpanel_get_suppressed_function_t)(nyx_device_t *d,
+        unsigned long *suppressed);
+
+/*
+ * Pinch, rotation and pan of the fingers down, touchpanel_mtdev only. It
+ * starts as the multiFingerGestures setting; each touch event carries the
+ * gesture of its frame, with state MULTI_FINGER_NONE when it did not change.
+ */
+typedef enum
+{
+	MULTI_FINGER_NONE = 0,      /**< no gesture in this frame */
+	MULTI_FINGER_BEGIN,         /**< a second finger went down */
+	MULTI_FINGER_UPDATE,
+	MULTI_FINGER_END,           /**< less than two fingers left */
+} multi_finger_state_t;
+
+/* Relative to the gesture start */
+typedef struct multi_finger_gesture
+{
+	multi_finger_state_t state;
+	int fingers;                /**< fingers taking part */
+	int centerX;                /**< centroid of the fingers */
+	int centerY;
+	int panX;                   /**< centroid movement, pixels */
+	int panY;
+	int scale;                  /**< finger spread, 1000 at the start */
+	int rotation;               /**< 1/100 degree, clockwise on screen */
+} multi_finger_gesture_t;
+
+#define TOUCHPANEL_SET_MULTI_FINGER_GESTURES_METHOD \
+	"touchpanel_set_multi_finger_gestures"
+#define TOUCHPANEL_GET_GESTURE_METHOD   "touchpanel_get_gesture"
+
+nyx_error_t touchpanel_set_multi_finger_gestures(nyx_device_t *d, bool enable);
+nyx_error_t touchpanel_get_gesture(nyx_device_t *d, nyx_event_t *e,
+                                   multi_finger_gesture_t *gesture);
+
+typedef nyx_error_t (*touchpanel_set_multi_finger_gestures_function_t)(
+    nyx_device_t *d, bool enable);
+typedef nyx_error_t (*touchpanel_get_gesture_function_t)(nyx_device_t *d,
+        nyx_event_t *e, multi_finger_gesture_t *gesture);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* __NYX_MODULES_TOUCHPANEL_H */
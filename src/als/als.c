@@ -29,12 +29,17 @@
 #include <nyx/module/nyx_utils.h>
 #include <nyx/module/nyx_log.h>
 #include "msgid.h"
+#include "evdev_mask.h"
 
 #define MAX_EVENTS		64
 #ifndef ALS_INPUT_DEVICE
 #define ALS_INPUT_DEVICE		"/sys/class/input/event4/"
 #endif
 
+/* the light level is all that is read from the sensor */
+static const unsigned int als_codes[] = { ABS_MISC };
+static const evdev_filter_t als_filter = { EV_ABS, als_codes, 1 };
+
 typedef struct {
 	nyx_device_t parent;
 	nyx_event_sensor_als_t *current_event_ptr;
@@ -87,6 +92,9 @@ nyx_error_t nyx_module_open(nyx_instance_t i, nyx_device_t** device)
 		return NYX_ERROR_INVALID_VALUE;
 	}
 
+	if (evdev_set_filter(als_device->fd, &als_filter, 1) < 0)
+		nyx_debug("[als] Events are not filtered by the kernel: %s", strerror(errno));
+
 	nyx_module_register_method(i, (nyx_device_t*) als_device,
 			NYX_GET_EVENT_SOURCE_MODULE_METHOD, "als_get_event_source");
 	nyx_module_register_method(i, (nyx_device_t*) als_device,
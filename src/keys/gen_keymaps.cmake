@@ -0,0 +1,70 @@
+# Copyright (c) 2026 agent <agent@local>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# Turn the keymaps in KEYMAP_DIR into tables indexed by evdev key code,
+# written as C to OUTPUT. The key names are left to the compiler to resolve.
+#
+#   cmake -DKEYMAP_DIR=<dir> -DOUTPUT=<file> -P gen_keymaps.cmake
+
+file(GLOB keymap_files "${KEYMAP_DIR}/*.keymap")
+list(SORT keymap_files)
+
+set(tables "")
+set(registry "")
+
+foreach(keymap_file ${keymap_files})
+	get_filename_component(name ${keymap_file} NAME_WE)
+	string(REGEX REPLACE "[^A-Za-z0-9_]" "_" id ${name})
+	file(STRINGS ${keymap_file} lines)
+
+	set(passthrough false)
+	set(entries "")
+	set(codes "")
+
+	foreach(line ${lines})
+		string(REGEX REPLACE "#.*$" "" line "${line}")
+		string(STRIP "${line}" line)
+
+		if(line STREQUAL "")
+			# comment or blank line
+		elseif(line MATCHES "^passthrough$")
+			set(passthrough true)
+		elseif(line MATCHES "^([A-Za-z0-9_]+)[ \t]+([A-Z0-9_]+)$")
+			set(code ${CMAKE_MATCH_1})
+			set(key ${CMAKE_MATCH_2})
+			list(FIND codes ${code} found)
+
+			if(NOT found EQUAL -1)
+				message(FATAL_ERROR "${keymap_file}: ${code} is mapped twice")
+			endif()
+
+			list(APPEND codes ${code})
+			set(entries "${entries}\t[${code}] = { true, NYX_KEYS_CUSTOM_KEY_${key} },\n")
+		else()
+			message(FATAL_ERROR "${keymap_file}: cannot parse \"${line}\"")
+		endif()
+	endforeach()
+
+	set(tables "${tables}static const keymap_entry_t keymap_${id}_entries[KEYMAP_SIZE] =\n{\n${entries}};\n\n")
+	set(tables "${tables}static const keymap_t keymap_${id} =\n{\n\t\"${name}\", ${passthrough}, keymap_${id}_entries\n};\n\n")
+	set(registry "${registry}\t&keymap_${id},\n")
+endforeach()
+
+file(WRITE ${OUTPUT}
+     "/* Generated by gen_keymaps.cmake from the keymaps directory, do not edit */\n\n"
+     "#include \"keymap.h\"\n\n"
+     "${tables}"
+     "const keymap_t *const keymaps[] =\n{\n${registry}\tNULL\n};\n")
@@ -0,0 +1,48 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef KEYMAP_H_
+#define KEYMAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <linux/input.h>
+
+#include <nyx/nyx_module.h>
+
+/*
+ * Keymaps are data files in keymaps/, turned into tables indexed by evdev key
+ * code at build time by gen_keymaps.cmake. Every one of them is built in.
+ */
+#define KEYMAP_SIZE     KEY_CNT
+
+typedef struct keymap_entry
+{
+	bool mapped;
+	int key;                            /**< nyx custom key */
+} keymap_entry_t;
+
+typedef struct keymap
+{
+	const char *name;                   /**< file name without .keymap */
+	bool passthrough;                   /**< report unmapped keys with their code */
+	const keymap_entry_t *entries;      /**< KEYMAP_SIZE entries */
+} keymap_t;
+
+/* NULL terminated */
+extern const keymap_t *const keymaps[];
+
+#endif
@@ -21,12 +21,13 @@
 #include <fcntl.h>
 #include <linux/input.h>
 #include <errno.h>
-#include <poll.h>
 #include <glib.h>
 #include <stdio.h>
-#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <sys/epoll.h>
+#include <libudev.h>
 
 #include <nyx/nyx_module.h>
 #include <nyx/module/nyx_utils.h>
@@ -34,19 +35,32 @@
 #include "msgid.h"
 
 #include "keys_common.h"
+#include "evdev_mask.h"
 
 NYX_DECLARE_MODULE(NYX_DEVICE_KEYS, "Keys");
 
 #define NYX_CONF_FILE           "/etc/nyx.conf"
 #define NYX_CONF_GROUP_KEYS     "module.keys"
 #define NYX_CONF_KEY_PATHS      "paths"
-
-#define MAX_INPUT_NODES         5
-
-int keypad_event_fd[MAX_INPUT_NODES];
-int num_keypad_event_fd = 0;
-int keypad_notifier_pipe_fds[2];
-pthread_t notifier_thread;
+#define NYX_CONF_KEY_HOTPLUG    "hotplug"
+#define NYX_CONF_KEY_PROPERTIES "hotplugProperties"
+#define NYX_CONF_KEY_KEYMAP     "keymap"
+
+/* keymap of the target, see keymaps/ */
+#ifndef KEYS_DEFAULT_KEYMAP
+#define KEYS_DEFAULT_KEYMAP     "device"
+#endif
+
+/* udev property of the devices taken with hotplug when none are configured */
+#define DEFAULT_HOTPLUG_PROPERTY    "ID_INPUT_KEY"
+
+/*
+ * All keypad fds are gathered in one epoll set, which is what the caller
+ * waits on; it becomes readable whenever one of the devices is. With hotplug
+ * the udev monitor is in the set as well, so devices come and go while the
+ * event source stays the same.
+ */
+int keypad_epoll_fd = -1;
 
 /**
  * This is modeled after the linux input event interface events.
@@ -60,11 +74,64 @@ typedef struct InputEvent
 	int32_t value;        /**< event value: coordinate, intensity,etc. */
 } InputEvent_t;
 
-static gchar** read_input_paths(guint *num_paths)
+#define KEYPAD_BUFFER_EVENTS    64
+#define KEYPAD_MAX_READY        16
+
+/*
+ * An open keypad device and the events read from it that are not merged into
+ * the queue yet, oldest first. A device is only read again once its buffer is
+ * empty, so one read() takes everything it has queued up to the buffer size.
+ * A device that went away leaves the epoll set at once, but its node is kept
+ * until the buffered events are delivered.
+ */
+typedef struct keypad_node
+{
+	int fd;                 /**< -1 once the device is gone */
+	dev_t devnum;
+	int head;
+	int count;
+	InputEvent_t events[KEYPAD_BUFFER_EVENTS];
+} keypad_node_t;
+
+static keypad_node_t **keypad_nodes = NULL;
+static int num_keypad_nodes = 0;
+static int max_keypad_nodes = 0;
+
+static const evdev_filter_t keypad_filter = { EV_KEY, NULL, 0 };
+
+static struct udev *keypad_udev = NULL;
+static struct udev_monitor *keypad_monitor = NULL;
+static gchar **hotplug_properties = NULL;
+
+typedef struct keys_conf
+{
+	gchar **paths;
+	bool hotplug;
+	gchar **properties;
+	gchar *keymap;
+} keys_conf_t;
+
+/*
+ * The module.keys group of the nyx configuration file lists the devices to
+ * open, and may ask for input devices to be picked up as they appear. Those
+ * are taken when one of the listed udev properties is set. The keymap is
+ * picked by name among the built in ones, e.g.
+ *
+ *   [module.keys]
+ *   paths=/dev/input/event1;/dev/input/event2
+ *   hotplug=true
+ *   hotplugProperties=ID_INPUT_KEY;ID_INPUT_KEYBOARD
+ *   keymap=emulator
+ *
+ * Without hotplug the paths are required.
+ */
+static bool read_conf(keys_conf_t *conf)
 {
     GError *error = NULL;
     GKeyFile *keyfile = NULL;
-    gchar **result = NULL;
+    bool result = false;
+
+    memset(conf, 0, sizeof(*conf));
 
     keyfile = g_key_file_new();
     g_key_file_set_list_separator(keyfile, ';');
@@ -75,44 +142,63 @@ static gchar** read_input_paths(guint *num_paths)
         goto cleanup;
     }
 
-    if (!g_key_file_has_key(keyfile, NYX_CONF_GROUP_KEYS, NYX_CONF_KEY_PATHS, &error)) {
+    conf->hotplug = g_key_file_get_boolean(keyfile, NYX_CONF_GROUP_KEYS, NYX_CONF_KEY_HOTPLUG, NULL);
+
+    conf->keymap = g_key_file_get_string(keyfile, NYX_CONF_GROUP_KEYS, NYX_CONF_KEY_KEYMAP, NULL);
+
+    if (conf->hotplug)
+        conf->properties = g_key_file_get_string_list(keyfile, NYX_CONF_GROUP_KEYS, NYX_CONF_KEY_PROPERTIES, NULL, NULL);
+
+    if (g_key_file_has_key(keyfile, NYX_CONF_GROUP_KEYS, NYX_CONF_KEY_PATHS, NULL)) {
+        conf->paths = g_key_file_get_string_list(keyfile, NYX_CONF_GROUP_KEYS, NYX_CONF_KEY_PATHS, NULL, NULL);
+    }
+    else if (!conf->hotplug) {
         nyx_error(MSGID_NYX_MOD_KEYS_CONF_FILE_PATH_ERR, 0, "Failed to read input paths from conf file");
-        g_error_free(error);
+        g_strfreev(conf->properties);
+        g_free(conf->keymap);
         goto cleanup;
     }
 
-    result = g_key_file_get_string_list(keyfile, NYX_CONF_GROUP_KEYS, NYX_CONF_KEY_PATHS, num_paths, NULL);
+    result = true;
 
 cleanup:
     g_key_file_free(keyfile);
     return result;
 }
 
-void *notifier_thread_func(void *user_data)
+static const keymap_t *find_keymap(const char *name)
 {
-    struct pollfd fds[MAX_INPUT_NODES];
-    int event = 1, n;
+    int n;
 
-    for (n = 0; n < num_keypad_event_fd; n++) {
-        fds[n].fd = keypad_event_fd[n];
-        fds[n].events = POLLIN;
+    for (n = 0; keymaps[n] != NULL; n++)
+    {
+        if (strcmp(keymaps[n]->name, name) == 0)
+        {
+            return keymaps[n];
+        }
     }
 
-    while (1) {
-        int ret_val = poll(fds, num_keypad_event_fd, -1);
-        if (ret_val <= 0)
-            continue;
+    return NULL;
+}
 
-        nyx_debug(MSGID_NYX_MOD_KEYS_NEW_INPUT_DEV, 0, "Got new input event; waking up main thread ..");
+/*
+ * One table access per key: keys the keymap lists report their custom key,
+ * the others their own code as a standard key or 0, as the keymap says.
+ */
+int lookup_key(keys_device_t* d, uint16_t keyCode, int32_t keyValue,
+        nyx_key_type_t* key_type_out_ptr)
+{
+    const keymap_t *keymap = d->keymap;
 
-        /* wakeup main thread */
-        (void) write(keypad_notifier_pipe_fds[1], &event, sizeof(int));
+    if (keyCode < KEYMAP_SIZE && keymap->entries[keyCode].mapped)
+    {
+        *key_type_out_ptr = NYX_KEY_TYPE_CUSTOM;
+        return keymap->entries[keyCode].key;
     }
 
-    return NULL;
+    return keymap->passthrough ? keyCode : 0;
 }
 
-
 static nyx_event_keys_t *keys_event_create()
 {
 	nyx_event_keys_t *event_ptr = (nyx_event_keys_t *) calloc(
@@ -146,12 +232,329 @@ nyx_error_t keys_release_event(nyx_device_t *d, nyx_event_t *e)
 	return NYX_ERROR_NONE;
 }
 
+static keypad_node_t *find_input_node(dev_t devnum)
+{
+    int n;
+
+    for (n = 0; n < num_keypad_nodes; n++)
+    {
+        if (keypad_nodes[n]->fd >= 0 && keypad_nodes[n]->devnum == devnum)
+        {
+            return keypad_nodes[n];
+        }
+    }
+
+    return NULL;
+}
+
+static int add_input_node(const char *path)
+{
+    struct epoll_event ev;
+    struct stat st;
+    keypad_node_t *node;
+    int fd;
+
+    nyx_debug(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Initializing input device %s", path);
+
+    fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        nyx_error(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Could not open keypad event file at %s", path);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+
+    /* a configured device can also be found by hotplug, under another name */
+    if (find_input_node(st.st_rdev) != NULL) {
+        close(fd);
+        return 0;
+    }
+
+    if (num_keypad_nodes == max_keypad_nodes)
+    {
+        int size = max_keypad_nodes ? 2 * max_keypad_nodes : 4;
+        keypad_node_t **nodes = realloc(keypad_nodes, size * sizeof(*nodes));
+
+        if (nodes == NULL)
+        {
+            nyx_error(MSGID_NYX_MOD_KEY_OUT_OF_MEM, 0, "Out of memory");
+            close(fd);
+            return -1;
+        }
+
+        keypad_nodes = nodes;
+        max_keypad_nodes = size;
+    }
+
+    node = calloc(1, sizeof(keypad_node_t));
+
+    if (node == NULL)
+    {
+        nyx_error(MSGID_NYX_MOD_KEY_OUT_OF_MEM, 0, "Out of memory");
+        close(fd);
+        return -1;
+    }
+
+    /* only key events are looked at, leave EV_MSC scan codes and the like out */
+    if (evdev_set_filter(fd, &keypad_filter, 1) < 0)
+    {
+        nyx_debug(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Events of %s are not filtered by the kernel: %s",
+                  path, strerror(errno));
+    }
+
+    node->fd = fd;
+    node->devnum = st.st_rdev;
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = node;
+
+    if (epoll_ctl(keypad_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+        nyx_error(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Failed to watch keypad event file: %s", strerror(errno));
+        close(fd);
+        free(node);
+        return -1;
+    }
+
+    keypad_nodes[num_keypad_nodes++] = node;
+
+    return 0;
+}
+
+/*
+ * Stop watching a device that went away. The node itself is freed by
+ * sweep_input_nodes() once its buffered events are delivered.
+ */
+static void drop_input_node(keypad_node_t *node)
+{
+    epoll_ctl(keypad_epoll_fd, EPOLL_CTL_DEL, node->fd, NULL);
+    close(node->fd);
+    node->fd = -1;
+}
+
+static void sweep_input_nodes(void)
+{
+    int n, kept = 0;
+
+    for (n = 0; n < num_keypad_nodes; n++)
+    {
+        keypad_node_t *node = keypad_nodes[n];
+
+        if (node->fd < 0 && node->count == 0)
+        {
+            free(node);
+        }
+        else
+        {
+            keypad_nodes[kept++] = node;
+        }
+    }
+
+    num_keypad_nodes = kept;
+}
+
+/*
+ * Only the evdev nodes of input devices with one of the configured
+ * properties are taken, not the input devices themselves or other handlers.
+ */
+static bool hotplug_device_matches(struct udev_device *dev)
+{
+    const char *sysname = udev_device_get_sysname(dev);
+    int n;
+
+    if (udev_device_get_devnode(dev) == NULL || sysname == NULL ||
+            strncmp(sysname, "event", 5) != 0)
+    {
+        return false;
+    }
+
+    for (n = 0; hotplug_properties[n] != NULL; n++)
+    {
+        const char *value = udev_device_get_property_value(dev, hotplug_properties[n]);
+
+        if (value != NULL && strcmp(value, "1") == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void handle_hotplug_event(void)
+{
+    struct udev_device *dev;
+
+    while ((dev = udev_monitor_receive_device(keypad_monitor)) != NULL)
+    {
+        const char *action = udev_device_get_action(dev);
+
+        if (action == NULL)
+        {
+            /* nothing to do */
+        }
+        else if (strcmp(action, "add") == 0 && hotplug_device_matches(dev))
+        {
+            nyx_info(MSGID_NYX_MOD_KEYS_NEW_INPUT_DEV, 0, "Adding input device %s",
+                     udev_device_get_devnode(dev));
+            add_input_node(udev_device_get_devnode(dev));
+        }
+        else if (strcmp(action, "remove") == 0)
+        {
+            keypad_node_t *node = find_input_node(udev_device_get_devnum(dev));
+
+            if (node != NULL)
+            {
+                nyx_info(MSGID_NYX_MOD_KEYS_NEW_INPUT_DEV, 0, "Removing input device %s",
+                         udev_device_get_devnode(dev));
+                drop_input_node(node);
+            }
+        }
+
+        udev_device_unref(dev);
+    }
+}
+
+static void close_hotplug(void)
+{
+    if (keypad_monitor != NULL)
+    {
+        epoll_ctl(keypad_epoll_fd, EPOLL_CTL_DEL, udev_monitor_get_fd(keypad_monitor), NULL);
+        udev_monitor_unref(keypad_monitor);
+        keypad_monitor = NULL;
+    }
+
+    if (keypad_udev != NULL)
+    {
+        udev_unref(keypad_udev);
+        keypad_udev = NULL;
+    }
+
+    g_strfreev(hotplug_properties);
+    hotplug_properties = NULL;
+}
+
+/*
+ * Watch for input devices coming and going, then take the matching devices
+ * already present. One that shows up in between is seen twice and only
+ * opened once. Takes ownership of properties.
+ */
+static int init_hotplug(gchar **properties)
+{
+    struct udev_enumerate *enumerate;
+    struct udev_list_entry *entry;
+    struct epoll_event ev;
+
+    hotplug_properties = properties ? properties : g_strsplit(DEFAULT_HOTPLUG_PROPERTY, ";", -1);
+
+    keypad_udev = udev_new();
+
+    if (keypad_udev == NULL)
+    {
+        nyx_error(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Could not initialize udev component");
+        return -1;
+    }
+
+    /* from udev rather than the kernel, the input properties are set by then */
+    keypad_monitor = udev_monitor_new_from_netlink(keypad_udev, "udev");
+
+    if (keypad_monitor == NULL ||
+            udev_monitor_filter_add_match_subsystem_devtype(keypad_monitor, "input", NULL) < 0 ||
+            udev_monitor_enable_receiving(keypad_monitor) < 0)
+    {
+        nyx_error(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Failed to set up udev monitor for input devices");
+        return -1;
+    }
+
+    /* nodes are never NULL, this marks the monitor */
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+
+    if (epoll_ctl(keypad_epoll_fd, EPOLL_CTL_ADD, udev_monitor_get_fd(keypad_monitor), &ev) < 0)
+    {
+        nyx_error(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Failed to watch udev monitor: %s", strerror(errno));
+        return -1;
+    }
+
+    enumerate = udev_enumerate_new(keypad_udev);
+
+    if (enumerate == NULL)
+    {
+        return 0;
+    }
+
+    udev_enumerate_add_match_subsystem(enumerate, "input");
+    udev_enumerate_scan_devices(enumerate);
+
+    udev_list_entry_foreach(entry, udev_enumerate_get_list_entry(enumerate))
+    {
+        struct udev_device *dev = udev_device_new_from_syspath(keypad_udev,
+                                  udev_list_entry_get_name(entry));
+
+        if (dev == NULL)
+        {
+            continue;
+        }
+
+        if (hotplug_device_matches(dev))
+        {
+            add_input_node(udev_device_get_devnode(dev));
+        }
+
+        udev_device_unref(dev);
+    }
+
+    udev_enumerate_unref(enumerate);
+
+    return 0;
+}
+
+static void close_input_nodes(void)
+{
+    int n;
+
+    close_hotplug();
+
+    for (n = 0; n < num_keypad_nodes; n++)
+    {
+        if (keypad_nodes[n]->fd >= 0)
+        {
+            close(keypad_nodes[n]->fd);
+        }
+
+        free(keypad_nodes[n]);
+    }
+
+    free(keypad_nodes);
+    keypad_nodes = NULL;
+    num_keypad_nodes = 0;
+    max_keypad_nodes = 0;
+
+    if (keypad_epoll_fd >= 0)
+    {
+        close(keypad_epoll_fd);
+        keypad_epoll_fd = -1;
+    }
+}
+
+static int open_event_source(void)
+{
+    keypad_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+    if (keypad_epoll_fd < 0)
+    {
+        nyx_error(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Failed to create epoll set: %s", strerror(errno));
+        return -1;
+    }
+
+    return 0;
+}
+
 nyx_error_t nyx_module_open(nyx_instance_t i, nyx_device_t **d)
 {
-    guint num_paths;
-    gchar **input_paths;
-    gchar *path;
-    int fd, n;
+    keys_conf_t conf;
+    const keymap_t *keymap;
+    int n;
 
 	if (NULL == d)
 	{
@@ -159,35 +562,57 @@ nyx_error_t nyx_module_open(nyx_instance_t i, nyx_device_t **d)
 	    return NYX_ERROR_INVALID_VALUE;
 	}
 
-    input_paths = read_input_paths(&num_paths);
-
-    if (input_paths == NULL)
+    if (!read_conf(&conf))
     {
         return NYX_ERROR_NOT_FOUND;
     }
 
-    for (n = 0; n < num_paths; n++) {
-        path = input_paths[n];
+    keymap = find_keymap(conf.keymap ? conf.keymap : KEYS_DEFAULT_KEYMAP);
 
-        if (num_keypad_event_fd == MAX_INPUT_NODES) {
-            nyx_warn(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Reached maximum number of input nodes. Skipping others.");
-            break;
-        }
+    if (keymap == NULL)
+    {
+        nyx_warn(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Unknown keymap %s, using %s", conf.keymap,
+                 KEYS_DEFAULT_KEYMAP);
+        keymap = find_keymap(KEYS_DEFAULT_KEYMAP);
+    }
 
-        nyx_debug(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Initializing input device %s", path);
+    g_free(conf.keymap);
 
-        fd = open(path, O_RDONLY);
-        if (fd < 0) {
-            nyx_error(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Could not open keypad event file at %s", path);
-            continue;
-        }
+    if (keymap == NULL)
+    {
+        nyx_error(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "No keymap %s built in", KEYS_DEFAULT_KEYMAP);
+        g_strfreev(conf.paths);
+        g_strfreev(conf.properties);
+        return NYX_ERROR_NOT_FOUND;
+    }
+
+    if (open_event_source() < 0)
+    {
+        g_strfreev(conf.paths);
+        g_strfreev(conf.properties);
+        return NYX_ERROR_GENERIC;
+    }
 
-        keypad_event_fd[num_keypad_event_fd] = fd;
-        num_keypad_event_fd++;
+    for (n = 0; conf.paths != NULL && conf.paths[n] != NULL; n++)
+    {
+        add_input_node(conf.paths[n]);
     }
 
-    if (num_keypad_event_fd == 0)
+    g_strfreev(conf.paths);
+
+    /* without udev the configured devices still work */
+    if (conf.hotplug && init_hotplug(conf.properties) < 0)
+    {
+        nyx_warn(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Input device hotplug not available");
+        close_hotplug();
+        conf.hotplug = false;
+    }
+
+    if (num_keypad_nodes == 0 && !conf.hotplug)
+    {
+        close_input_nodes();
         return NYX_ERROR_NOT_FOUND;
+    }
 
 	keys_device_t *keys_device = (keys_device_t *) calloc(sizeof(keys_device_t),
 	                             1);
@@ -195,9 +620,12 @@ nyx_error_t nyx_module_open(nyx_instance_t i, nyx_device_t **d)
 	if (G_UNLIKELY(!keys_device))
 	{
 		nyx_error(MSGID_NYX_MOD_KEY_OUT_OF_MEM, 0, "Out of memory");
+		close_input_nodes();
 		return NYX_ERROR_OUT_OF_MEMORY;
 	}
 
+	keys_device->keymap = keymap;
+
 	nyx_module_register_method(i, (nyx_device_t *) keys_device,
 	                           NYX_GET_EVENT_SOURCE_MODULE_METHOD, "keys_get_event_source");
 	nyx_module_register_method(i, (nyx_device_t *) keys_device,
@@ -207,14 +635,7 @@ nyx_error_t nyx_module_open(nyx_instance_t i, nyx_device_t **d)
 
 	*d = (nyx_device_t *) keys_device;
 
-    notifier_thread = pthread_create(&notifier_thread, NULL, notifier_thread_func, NULL);
-    pipe2(&keypad_notifier_pipe_fds, 0);
-
     return NYX_ERROR_NONE;
-
-fail_unlock_settings:
-
-    return NYX_ERROR_GENERIC;
 }
 
 nyx_error_t nyx_module_close(nyx_device_t *d)
@@ -234,6 +655,8 @@ nyx_error_t nyx_module_close(nyx_device_t *d)
 	nyx_debug(MSGID_NYX_MOD_KEYS_OPEN_ERR, 0, "Freeing keys %p", d);
 	free(d);
 
+	close_input_nodes();
+
 	return NYX_ERROR_NONE;
 }
 
@@ -249,57 +672,119 @@ nyx_error_t keys_get_event_source(nyx_device_t *d, int *f)
 		return NYX_ERROR_INVALID_VALUE;
 	}
 
-    *f = keypad_notifier_pipe_fds[0];
+    *f = keypad_epoll_fd;
 
     return NYX_ERROR_NONE;
 }
 
+/*
+ * Fill the buffer of a ready device, unless it still holds events.
+ */
+static void fill_keypad_buffer(keypad_node_t *node)
+{
+    int rd;
+
+    if (node->count > 0 || node->fd < 0)
+    {
+        return;
+    }
+
+    /* keep looping if get EINTR */
+    do
+    {
+        rd = read(node->fd, node->events, sizeof(node->events));
+    }
+    while (rd < 0 && errno == EINTR);
+
+    if (rd < 0 && errno == ENODEV)
+    {
+        /* unplugged, udev may not have told yet */
+        drop_input_node(node);
+    }
+    else if (rd < 0 && errno != EAGAIN)
+    {
+        nyx_error(MSGID_NYX_MOD_KEY_EVENT_READ_ERR, 0, "Failed to read events from keypad event file");
+    }
+
+    node->head = 0;
+    node->count = rd > 0 ? rd / sizeof(InputEvent_t) : 0;
+}
+
+static bool event_before(const InputEvent_t *a, const InputEvent_t *b)
+{
+    return timercmp(&a->time, &b->time, <);
+}
+
+/*
+ * Read the ready devices and merge what the devices have buffered into
+ * pEvents by kernel timestamp, keeping the order of each device. Events that
+ * do not fit stay buffered for the next call. The epoll set is level
+ * triggered, a device is only read once its buffer is empty and otherwise
+ * keeps the event source readable. Hotplug changes are applied after the
+ * reads.
+ */
 int read_input_event(InputEvent_t* pEvents, int maxEvents)
 {
+    struct epoll_event ready[KEYPAD_MAX_READY];
+    bool hotplug = false;
     int numEvents = 0;
-    int rd = 0, n, event;
-    struct pollfd fds[MAX_INPUT_NODES];
+    int n, numReady;
 
 	if (pEvents == NULL)
 	{
 		return -1;
 	}
 
-    /* clear notifier pipe */
-    (void) read(keypad_notifier_pipe_fds[0], &event, sizeof(int));
+    do
+    {
+        numReady = epoll_wait(keypad_epoll_fd, ready, KEYPAD_MAX_READY, 0);
+    }
+    while (numReady < 0 && errno == EINTR);
 
-    for (n = 0; n < num_keypad_event_fd; n++) {
-        fds[n].fd = keypad_event_fd[n];
-        fds[n].events = POLLIN;
+    for (n = 0; n < numReady; n++)
+    {
+        if (ready[n].data.ptr == NULL)
+        {
+            hotplug = true;
+        }
+        else
+        {
+            fill_keypad_buffer(ready[n].data.ptr);
+        }
     }
 
-    int ret_val = poll(fds, num_keypad_event_fd, 0);
-    if (ret_val <= 0)
-        return 0;
+    if (hotplug)
+    {
+        handle_hotplug_event();
+    }
 
-    for (n = 0; n < num_keypad_event_fd; n++)
+    /* k-way merge, there are a handful of devices so a linear scan will do */
+    while (numEvents < maxEvents)
     {
-        if (fds[n].revents & POLLIN) 
+        keypad_node_t *next = NULL;
+
+        for (n = 0; n < num_keypad_nodes; n++)
         {
-            /* keep looping if get EINTR */
-            for (;;) 
+            keypad_node_t *node = keypad_nodes[n];
+
+            if (node->count > 0 && (next == NULL ||
+                                    event_before(&node->events[node->head], &next->events[next->head])))
             {
-                rd = read(fds[n].fd, pEvents, sizeof(InputEvent_t) * maxEvents);
-
-                if (rd > 0) 
-                {
-                    numEvents += rd / sizeof(InputEvent_t);
-                    break;
-                }
-                else if (rd < 0 && errno != EINTR) 
-                {
-    				nyx_error(MSGID_NYX_MOD_KEY_EVENT_READ_ERR, 0, "Failed to read events from keypad event file");
-                    break;
-                }
+                next = node;
             }
         }
+
+        if (next == NULL)
+        {
+            break;
+        }
+
+        pEvents[numEvents++] = next->events[next->head++];
+        next->count--;
     }
 
+    sweep_input_nodes();
+
 	return numEvents;
 }
 
@@ -312,66 +797,75 @@ nyx_error_t keys_get_event(nyx_device_t *d, nyx_event_t **e)
 	static int event_count = 0;
 	static int event_iter = 0;
 
-    int rd = 0;
-
+	nyx_event_t *generated = NULL;
 	keys_device_t *keys_device = (keys_device_t *) d;
 
 	/*
-	 * Event bookkeeping...
+	 * A batch without key events is followed by the next one, the devices
+	 * may still have events buffered that the event source no longer
+	 * signals.
 	 */
-	if (!event_iter)
-	{
-		event_count = read_input_event(raw_events, MAX_EVENTS);
-		keys_device->current_event_ptr = NULL;
-	}
-
-	if (keys_device->current_event_ptr == NULL)
+	do
 	{
 		/*
-		 * let's allocate new event and hold it here.
+		 * Event bookkeeping...
 		 */
-		keys_device->current_event_ptr = keys_event_create();
-	}
-
-	for (; event_iter < event_count;)
-	{
-		InputEvent_t *input_event_ptr;
-		input_event_ptr = &raw_events[event_iter];
-		event_iter++;
-
-		if (input_event_ptr->type == EV_KEY)
+		if (!event_iter)
 		{
-			keys_device->current_event_ptr->key_type = NYX_KEY_TYPE_STANDARD;
-			keys_device->current_event_ptr->key = lookup_key(keys_device,
-			                                      input_event_ptr->code, input_event_ptr->value,
-			                                      &keys_device->current_event_ptr->key_type);
+			event_count = read_input_event(raw_events, MAX_EVENTS);
 		}
-		else
+
+		if (keys_device->current_event_ptr == NULL)
 		{
-			continue;
+			/*
+			 * let's allocate new event and hold it here.
+			 */
+			keys_device->current_event_ptr = keys_event_create();
 		}
 
-		keys_device->current_event_ptr->key_is_press
-		    = (input_event_ptr->value) ? true : false;
-		keys_device->current_event_ptr->key_is_auto_repeat
-		    = (input_event_ptr->value > 1) ? true : false;
-
-		*e = (nyx_event_t *) keys_device->current_event_ptr;
-		keys_device->current_event_ptr = NULL;
+		for (; event_iter < event_count;)
+		{
+			InputEvent_t *input_event_ptr;
+			input_event_ptr = &raw_events[event_iter];
+			event_iter++;
+
+			if (input_event_ptr->type == EV_KEY)
+			{
+				keys_device->current_event_ptr->key_type = NYX_KEY_TYPE_STANDARD;
+				keys_device->current_event_ptr->key = lookup_key(keys_device,
+				                                      input_event_ptr->code, input_event_ptr->value,
+				                                      &keys_device->current_event_ptr->key_type);
+			}
+			else
+			{
+				continue;
+			}
+
+			keys_device->current_event_ptr->key_is_press
+			    = (input_event_ptr->value) ? true : false;
+			keys_device->current_event_ptr->key_is_auto_repeat
+			    = (input_event_ptr->value > 1) ? true : false;
+
+			generated = (nyx_event_t *) keys_device->current_event_ptr;
+			keys_device->current_event_ptr = NULL;
+
+			/*
+			 * Generated event, bail out and let the caller know.
+			 */
+			if (NULL != generated)
+			{
+				break;
+			}
+		}
 
-		/*
-		 * Generated event, bail out and let the caller know.
-		 */
-		if (NULL != *e)
+		if (event_iter >= event_count)
 		{
-			break;
+			event_iter = 0;
 		}
 	}
+	while (generated == NULL && event_count > 0);
 
-	if (event_iter >= event_count)
-	{
-		event_iter = 0;
-	}
+	*e = generated;
 
 	return NYX_ERROR_NONE;
 }
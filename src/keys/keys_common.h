@@ -17,9 +17,12 @@
 #ifndef KEYS_COMMON_H_
 #define KEYS_COMMON_H_
 
+#include "keymap.h"
+
 typedef struct {
     nyx_device_t _parent;
     nyx_event_keys_t* current_event_ptr;
+    const keymap_t* keymap;
 } keys_device_t;
 
 int lookup_key(keys_device_t* d, uint16_t keyCode, int32_t keyValue,
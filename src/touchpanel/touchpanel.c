@@ -46,6 +46,9 @@
 #include <fcntl.h>
 
 #include "touchpanel_gestures.h"
+#include "touchpanel_common.h"
+#include "touchpanel_latency.h"
+#include "coord_transform.h"
 #include "msgid.h"
 
 /* Later versions of nyx_utils.h no longer define this macro */
@@ -73,6 +76,7 @@ typedef struct
 	size_t input_filled;
 	size_t input_read;
 	input_event_t input[MAX_HIDD_EVENTS];
+	latency_queue_t latency;    /**< records of the frames in input */
 } event_list_t;
 
 
@@ -321,6 +325,24 @@ static general_settings_t sGeneralSettings =
 	.fingerDownThreshold = 0
 };
 
+/* device to display coordinates, calibration included */
+static coord_transform_t sTransform;
+static double sCalibration[6] = { 1, 0, 0, 0, 1, 0 };
+
+/* calibration from the nyx configuration file, see load_calibration() */
+static void
+load_calibration_conf(double *matrix)
+{
+	GKeyFile *keyfile = g_key_file_new();
+
+	if (g_key_file_load_from_file(keyfile, NYX_CONF_FILE, G_KEY_FILE_NONE, NULL))
+	{
+		load_calibration(keyfile, matrix);
+	}
+
+	g_key_file_free(keyfile);
+}
+
 #define FRAMEBUF_DEVICE_NAME    "/dev/fb"
 
 static int
@@ -354,7 +376,44 @@ exit:
 }
 
 
-static float scaleX, scaleY;
+/*
+ * Have the kernel stamp events with CLOCK_MONOTONIC so wall clock changes do
+ * not end up in the gesture math or in the timestamps handed upstream.
+ */
+static void
+init_event_clock(int fd)
+{
+	int clockId = CLOCK_MONOTONIC;
+
+	if (ioctl(fd, EVIOCSCLOCKID, &clockId) < 0)
+	{
+		nyx_warn(MSGID_NYX_MOD_TP_CLOCK, 0,
+		         "Touch events stay on CLOCK_REALTIME, EVIOCSCLOCKID failed: %s",
+		         strerror(errno));
+		latency_set_clock(CLOCK_REALTIME);
+		return;
+	}
+
+	latency_set_clock(CLOCK_MONOTONIC);
+}
+
+/*
+ * Map device coordinates onto the display through the configured calibration,
+ * falling back to plain scaling if it cannot be represented.
+ */
+static int
+init_coord_transform(int maxX, int maxY, int xres, int yres)
+{
+	if (coord_transform_init(&sTransform, maxX, maxY, xres, yres,
+	                         sCalibration) == 0)
+	{
+		return 0;
+	}
+
+	nyx_warn(MSGID_NYX_MOD_TP_CALIBRATION, 0,
+	         "Unusable calibration matrix, touches are only scaled");
+	return coord_transform_init(&sTransform, maxX, maxY, xres, yres, NULL);
+}
 
 static int
 init_touchpanel(void)
@@ -374,6 +433,14 @@ init_touchpanel(void)
 		return -1;
 	}
 
+	init_event_clock(touchpanel_event_fd);
+
+	if (filter_single_touch_events(touchpanel_event_fd) < 0)
+	{
+		nyx_debug("[touchpanel] Events are not filtered by the kernel: %s",
+		          strerror(errno));
+	}
+
 	ret = ioctl(touchpanel_event_fd, EVIOCGABS(0), &abs);
 
 	if (ret < 0)
@@ -397,6 +464,7 @@ init_touchpanel(void)
 	// The following function is valid only for virtualbox qemux86 image
 	init_vbox_touchpanel();
 	init_gesture_state_machine(&sGeneralSettings, 1);
+	load_calibration_conf(sCalibration);
 
 	/* Get the display resolution */
 	if (get_display_res(&sXres, &sYres) < 0)
@@ -405,8 +473,13 @@ init_touchpanel(void)
 		goto error;
 	}
 
-	scaleX = (float)sXres / (float)maxX;
-	scaleY = (float)sYres / (float)maxY;
+	if (init_coord_transform(maxX, maxY, sXres, sYres) < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_CALIBRATION, 0,
+		          "Invalid touchpanel range %dx%d", maxX, maxY);
+		ret = -1;
+		goto error;
+	}
 
 	return 0;
 error:
@@ -485,6 +558,8 @@ nyx_error_t nyx_module_close(nyx_device_t *d)
 
 	nyx_debug("Freeing touchpanel %p", d);
 
+	touchpanel_dump_latency(d);
+
 	deinit_gesture_state_machine();
 	free(d);
 
@@ -522,29 +597,30 @@ nyx_error_t touchpanel_set_operating_mode(nyx_device_t *d,
 	return NYX_ERROR_NOT_IMPLEMENTED;
 }
 
-void
-get_time_stamp(time_stamp_t *pTime)
+/*
+ * The gesture state machine runs on the time the kernel captured the event
+ * at, not when we got around to processing it, so scheduling jitter stays out
+ * of the velocity and flick computations.
+ */
+static void
+event_time_stamp(const struct timeval *tv, time_stamp_t *pTime)
 {
-	struct timeval tv;
-	(void)gettimeofday(&tv, NULL);
-
-	pTime->time.tv_sec = tv.tv_sec;
-	pTime->time.tv_nsec = tv.tv_usec * 1000;
+	pTime->time.tv_sec = tv->tv_sec;
+	pTime->time.tv_nsec = tv->tv_usec * 1000;
 }
 
 
 int cachedX, cachedY;
 
 static void
-generate_mouse_gesture(int touchButtonState)
+generate_mouse_gesture(int touchButtonState, const struct timeval *time)
 {
 	int32_t xOrd[2], yOrd[2], wOrd[2], fingers;
 	time_stamp_t eventTime;
 	int num_events = 0;
 
-	get_time_stamp(&eventTime);
-	xOrd[0] = cachedX;
-	yOrd[0] = cachedY;
+	event_time_stamp(time, &eventTime);
+	coord_transform_apply(&sTransform, cachedX, cachedY, &xOrd[0], &yOrd[0]);
 	wOrd[0] = touchButtonState ? 1 : 0;
 	fingers = touchButtonState ? 1 : 0;
 
@@ -552,8 +628,8 @@ generate_mouse_gesture(int touchButtonState)
 	yOrd[1] = 0;
 	wOrd[1] = 0;
 
-	gesture_state_machine(xOrd, yOrd, wOrd, fingers, &eventTime,
-	                      touchpanel_event_list.input, &num_events);
+	gesture_state_machine(0, xOrd, yOrd, wOrd, fingers, &eventTime,
+	                      touchpanel_event_list.input, MAX_HIDD_EVENTS, &num_events);
 	touchpanel_event_list.input_filled = num_events * sizeof(input_event_t);
 	touchpanel_event_list.input_read = 0;
 }
@@ -570,15 +646,15 @@ static void handle_new_event(input_event_t *event)
 {
 	static int touchButtonState = 0;
 
-	// Truncate scaled X & Y coordinate values
+	// Raw X & Y coordinates, transformed when the gesture is generated
 	if ((event->type == EV_ABS) && (event->code == ABS_X))
 	{
-		cachedX = (int)(event->value * scaleX);
+		cachedX = (int)(event->value);
 	}
 
 	else if ((event->type == EV_ABS) && (event->code == ABS_Y))
 	{
-		cachedY = (int)(event->value * scaleY);
+		cachedY = (int)(event->value);
 	}
 
 	// qemu touchpanel sends BTN_TOUCH, virtualbox touchpanel sends BTN_LEFT
@@ -595,12 +671,12 @@ static void handle_new_event(input_event_t *event)
 			* button has been down in the same spot and not create flicks
 			* if it has been down for long enough
 			*/
-			generate_mouse_gesture(1);
+			generate_mouse_gesture(1, &event->time);
 		}
 	}
 	else if (event->type == EV_SYN)
 	{
-		generate_mouse_gesture(touchButtonState);
+		generate_mouse_gesture(touchButtonState, &event->time);
 	}
 
 	if ((event->type == EV_REL && event->code == REL_WHEEL) ||
@@ -654,7 +730,15 @@ read_input_event(void)
 			return -1;
 		}
 
+		latency_queue_reset(&touchpanel_event_list.latency);
 		handle_new_event(&pEvent);
+
+		/* a new frame restarts the event list */
+		if (touchpanel_event_list.input_read == 0 &&
+		        touchpanel_event_list.input_filled > 0)
+		{
+			latency_frame_queued(&touchpanel_event_list.latency, &pEvent.time);
+		}
 	}
 
 	return numEvents;
@@ -746,6 +830,14 @@ nyx_error_t touchpanel_get_event(nyx_device_t *d, nyx_event_t **e)
 					{
 						item_ptr->y = input_event_ptr->value;
 					}
+					else if (ABS_VELOCITY_X == input_event_ptr->code)
+					{
+						item_ptr->xVelocity = input_event_ptr->value;
+					}
+					else if (ABS_VELOCITY_Y == input_event_ptr->code)
+					{
+						item_ptr->yVelocity = input_event_ptr->value;
+					}
 					else
 					{
 						nyx_error(MSGID_NYX_MOD_TP_ABS_ERR, 0, "Unexpected code 0x%x", input_event_ptr->code);
@@ -778,6 +870,7 @@ nyx_error_t touchpanel_get_event(nyx_device_t *d, nyx_event_t **e)
 			case EV_SYN:
 				p_generated = (nyx_event_t *) touch_device->current_event_ptr;
 				touch_device->current_event_ptr = NULL;
+				latency_frame_returned(&touchpanel_event_list.latency);
 
 				break;
 
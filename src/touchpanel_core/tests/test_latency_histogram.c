@@ -0,0 +1,204 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <glib.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#ifndef g_assert_true
+#define g_assert_true(X) g_assert((X))
+#endif
+
+//*****************************************************************************
+//*****************************************************************************
+
+// Pull in the unit under test
+#include "../../utils/latency_histogram.c"
+
+//*****************************************************************************
+//*****************************************************************************
+
+#define TEST_THREADS        4
+#define TEST_RECORDS        100000
+
+//
+// Every value lands in a bucket whose upper bound covers it, the next value
+// past that bound starts the next bucket, and the relative error stays
+// within one sub bucket
+//
+static void test_bucket_boundaries(void)
+{
+	uint64_t value;
+	int bit, index;
+
+	for (value = 0; value < LATENCY_HISTOGRAM_SUB_BUCKETS; value++)
+	{
+		g_assert_cmpint(bucket_index(value), ==, (int) value);
+		g_assert_cmpuint(bucket_upper_bound((int) value), ==, value);
+	}
+
+	g_assert_cmpint(bucket_index(16), ==, 16);
+	g_assert_cmpint(bucket_index(31), ==, 31);
+	g_assert_cmpint(bucket_index(32), ==, 32);
+	g_assert_cmpint(bucket_index(33), ==, 32);
+	g_assert_cmpint(bucket_index(34), ==, 33);
+	g_assert_cmpuint(bucket_upper_bound(32), ==, 33);
+
+	for (value = 0; value < 1 << 16; value++)
+	{
+		index = bucket_index(value);
+		g_assert_cmpuint(bucket_upper_bound(index), >=, value);
+		g_assert_cmpuint(bucket_upper_bound(index) - value, <=,
+		                 value / LATENCY_HISTOGRAM_SUB_BUCKETS);
+	}
+
+	for (bit = LATENCY_HISTOGRAM_SUB_BITS; bit <= LATENCY_HISTOGRAM_MAX_BIT; bit++)
+	{
+		value = 1ULL << bit;
+		index = bucket_index(value);
+		g_assert_cmpint(bucket_index(value - 1), ==, index - 1);
+		g_assert_cmpuint(bucket_upper_bound(index - 1), ==, value - 1);
+		g_assert_cmpint(bucket_index(bucket_upper_bound(index)), ==, index);
+		g_assert_cmpint(bucket_index(bucket_upper_bound(index) + 1), ==,
+		                index + 1 < LATENCY_HISTOGRAM_BUCKETS ? index + 1 : index);
+	}
+
+	// Anything past the tracked range saturates into the last bucket
+	g_assert_cmpint(bucket_index(1ULL << (LATENCY_HISTOGRAM_MAX_BIT + 1)), ==,
+	                LATENCY_HISTOGRAM_BUCKETS - 1);
+	g_assert_cmpint(bucket_index(UINT64_MAX), ==, LATENCY_HISTOGRAM_BUCKETS - 1);
+}
+
+//
+// Percentiles of 1..100 report the upper bound of the matching bucket,
+// capped to the recorded maximum; negative values count as zero
+//
+static void test_percentiles(void)
+{
+	latency_histogram_t h;
+	int64_t value;
+
+	latency_histogram_reset(&h);
+	g_assert_cmpuint(latency_histogram_percentile(&h, 50), ==, 0);
+
+	for (value = 100; value >= 1; value--)
+	{
+		latency_histogram_record(&h, value);
+	}
+
+	g_assert_cmpuint(latency_histogram_count(&h), ==, 100);
+	g_assert_cmpuint(latency_histogram_max(&h), ==, 100);
+
+	g_assert_cmpuint(latency_histogram_percentile(&h, 0), ==, 1);
+	g_assert_cmpuint(latency_histogram_percentile(&h, 10), ==, 10);
+	g_assert_cmpuint(latency_histogram_percentile(&h, 50), ==, 51);
+	g_assert_cmpuint(latency_histogram_percentile(&h, 90), ==, 91);
+	g_assert_cmpuint(latency_histogram_percentile(&h, 99), ==, 99);
+	g_assert_cmpuint(latency_histogram_percentile(&h, 100), ==, 100);
+
+	latency_histogram_record(&h, -5);
+	g_assert_cmpuint(h.counts[0], ==, 1);
+	g_assert_cmpuint(latency_histogram_count(&h), ==, 101);
+	g_assert_cmpuint(latency_histogram_percentile(&h, 0), ==, 0);
+}
+
+//
+// A reset clears every counter, and the histogram records afresh after it
+//
+static void test_reset(void)
+{
+	latency_histogram_t h;
+	int i;
+
+	latency_histogram_reset(&h);
+	latency_histogram_record(&h, 1000);
+	latency_histogram_record(&h, 5000000);
+
+	latency_histogram_reset(&h);
+	g_assert_cmpuint(latency_histogram_count(&h), ==, 0);
+	g_assert_cmpuint(latency_histogram_max(&h), ==, 0);
+	g_assert_cmpuint(latency_histogram_percentile(&h, 99), ==, 0);
+
+	for (i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+	{
+		g_assert_cmpuint(h.counts[i], ==, 0);
+	}
+
+	latency_histogram_record(&h, 20);
+	g_assert_cmpuint(latency_histogram_count(&h), ==, 1);
+	g_assert_cmpuint(latency_histogram_max(&h), ==, 20);
+	g_assert_cmpuint(latency_histogram_percentile(&h, 50), ==, 20);
+}
+
+static void *recorder(void *arg)
+{
+	latency_histogram_t *h = arg;
+	int64_t i;
+
+	for (i = 1; i <= TEST_RECORDS; i++)
+	{
+		latency_histogram_record(h, i);
+	}
+
+	return NULL;
+}
+
+//
+// Threads recording concurrently lose neither samples nor the maximum
+//
+static void test_threaded(void)
+{
+	latency_histogram_t h;
+	pthread_t threads[TEST_THREADS];
+	uint64_t sum = 0;
+	int i;
+
+	latency_histogram_reset(&h);
+
+	for (i = 0; i < TEST_THREADS; i++)
+	{
+		g_assert_cmpint(pthread_create(&threads[i], NULL, recorder, &h), ==, 0);
+	}
+
+	for (i = 0; i < TEST_THREADS; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+
+	for (i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+	{
+		sum += h.counts[i];
+	}
+
+	g_assert_cmpuint(latency_histogram_count(&h), ==, TEST_THREADS * TEST_RECORDS);
+	g_assert_cmpuint(sum, ==, TEST_THREADS * TEST_RECORDS);
+	g_assert_cmpuint(latency_histogram_max(&h), ==, TEST_RECORDS);
+}
+
+//
+// Set-up GLib, then register and run the tests.
+int main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/utils/latency_histogram/bucket_boundaries",
+	                test_bucket_boundaries);
+	g_test_add_func("/utils/latency_histogram/percentiles", test_percentiles);
+	g_test_add_func("/utils/latency_histogram/reset", test_reset);
+	g_test_add_func("/utils/latency_histogram/threaded", test_threaded);
+
+	return g_test_run();
+}
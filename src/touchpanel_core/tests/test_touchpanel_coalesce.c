@@ -0,0 +1,386 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <glib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef g_assert_true
+#define g_assert_true(X) g_assert((X))
+#endif
+
+//*****************************************************************************
+//*****************************************************************************
+
+// Pull in the unit under test
+#include "../touchpanel_coalesce.c"
+
+//*****************************************************************************
+//*****************************************************************************
+
+#define TEST_MAX_EVENTS     128
+#define TEST_MAX_FINGERS    8
+#define TEST_MAX_FRAMES     16
+
+static input_event_t test_events[TEST_MAX_EVENTS];
+static int test_num_events;
+static uint32_t test_fingers[TEST_MAX_FINGERS];
+static int test_frames[TEST_MAX_FRAMES];
+static coalesce_scratch_t test_scratch =
+{
+	.fingers = test_fingers,
+	.maxFingers = TEST_MAX_FINGERS,
+	.framesKept = test_frames,
+	.maxFrames = TEST_MAX_FRAMES
+};
+
+static void add_event(uint16_t type, uint16_t code, int32_t value)
+{
+	input_event_t *ev = &test_events[test_num_events++];
+
+	memset(ev, 0, sizeof(*ev));
+	ev->type = type;
+	ev->code = code;
+	ev->value = value;
+}
+
+//
+// One item as reported by the gesture state machine, button is -1 for a move
+//
+static void add_item(uint32_t id, int x, int button)
+{
+	add_event(EV_FINGERID, 0, id);
+
+	if (button == 1)
+	{
+		add_event(EV_KEY, BTN_TOUCH, 1);
+	}
+
+	add_event(EV_ABS, ABS_X, x);
+	add_event(EV_ABS, ABS_Y, 0);
+
+	if (button == 0)
+	{
+		add_event(EV_KEY, BTN_TOUCH, 0);
+	}
+}
+
+static void end_frame(void)
+{
+	add_event(EV_SYN, 0, 0);
+}
+
+//
+// Item of a finger delta frames left out as unchanged
+//
+static void add_unchanged(uint32_t id)
+{
+	add_event(EV_FINGERID, FINGER_UNCHANGED, id);
+}
+
+//
+// x reported for every item of a finger but unchanged ones, in order
+//
+static int items_of(uint32_t id, int *x, int max)
+{
+	int i, n = 0;
+
+	for (i = 0; i < test_num_events; i++)
+	{
+		if (test_events[i].type == EV_FINGERID && test_events[i].value == id &&
+		        test_events[i].code != FINGER_UNCHANGED)
+		{
+			for (i++; i < test_num_events && test_events[i].type == EV_KEY; i++)
+				;
+
+			if (n < max)
+			{
+				x[n] = test_events[i].value;
+			}
+
+			n++;
+		}
+	}
+
+	return n;
+}
+
+static int unchanged_of(uint32_t id)
+{
+	int i, n = 0;
+
+	for (i = 0; i < test_num_events; i++)
+	{
+		n += test_events[i].type == EV_FINGERID && test_events[i].value == id &&
+		     test_events[i].code == FINGER_UNCHANGED;
+	}
+
+	return n;
+}
+
+static int count_type(uint16_t type)
+{
+	int i, n = 0;
+
+	for (i = 0; i < test_num_events; i++)
+	{
+		n += test_events[i].type == type;
+	}
+
+	return n;
+}
+
+static int run_coalesce(unsigned long *merged, int *frames)
+{
+	test_num_events = coalesce_moves(test_events, test_num_events, &test_scratch,
+	                                 frames, merged);
+	return test_num_events;
+}
+
+//
+// Moves of a finger collapse to the latest one, frames left empty go away.
+static void test_moves_collapse(void)
+{
+	unsigned long merged = 0;
+	int x[8], frames, i;
+
+	test_num_events = 0;
+
+	for (i = 0; i < 4; i++)
+	{
+		add_item(1, 10 * i, -1);
+		end_frame();
+	}
+
+	run_coalesce(&merged, &frames);
+
+	g_assert_cmpint(merged, ==, 3);
+	g_assert_cmpint(frames, ==, 1);
+	g_assert_cmpint(test_frames[0], ==, 3);
+	g_assert_cmpint(items_of(1, x, 8), ==, 1);
+	g_assert_cmpint(x[0], ==, 30);
+	g_assert_cmpint(count_type(EV_SYN), ==, 1);
+}
+
+//
+// Down and up items are kept, along with the last move before the up.
+static void test_transitions_kept(void)
+{
+	unsigned long merged = 0;
+	int x[8], frames;
+
+	test_num_events = 0;
+	add_item(1, 0, 1);
+	end_frame();
+	add_item(1, 10, -1);
+	end_frame();
+	add_item(1, 20, -1);
+	end_frame();
+	add_item(1, 30, -1);
+	end_frame();
+	add_item(1, 30, 0);
+	end_frame();
+
+	run_coalesce(&merged, &frames);
+
+	g_assert_cmpint(merged, ==, 2);
+	g_assert_cmpint(frames, ==, 3);
+	g_assert_cmpint(test_frames[0], ==, 0);
+	g_assert_cmpint(test_frames[1], ==, 3);
+	g_assert_cmpint(test_frames[2], ==, 4);
+	g_assert_cmpint(items_of(1, x, 8), ==, 3);
+	g_assert_cmpint(x[0], ==, 0);
+	g_assert_cmpint(x[1], ==, 30);
+	g_assert_cmpint(x[2], ==, 30);
+}
+
+//
+// Fingers are coalesced independently; a frame survives as long as one of
+// its items does.
+static void test_independent_fingers(void)
+{
+	unsigned long merged = 0;
+	int x[8], frames;
+
+	test_num_events = 0;
+	add_item(1, 10, -1);
+	add_item(2, 100, -1);
+	end_frame();
+	add_item(1, 20, -1);
+	add_item(2, 200, 0);
+	end_frame();
+	add_item(1, 30, -1);
+	end_frame();
+
+	run_coalesce(&merged, &frames);
+
+	g_assert_cmpint(merged, ==, 2);
+	g_assert_cmpint(frames, ==, 3);
+	g_assert_cmpint(items_of(1, x, 8), ==, 1);
+	g_assert_cmpint(x[0], ==, 30);
+	g_assert_cmpint(items_of(2, x, 8), ==, 2);
+	g_assert_cmpint(x[0], ==, 100);
+	g_assert_cmpint(x[1], ==, 200);
+}
+
+//
+// Frames without finger items (wheel keys) are passed through.
+static void test_other_events_untouched(void)
+{
+	unsigned long merged = 0;
+	int frames, before;
+
+	test_num_events = 0;
+	add_event(EV_REL, REL_WHEEL, 1);
+	add_event(EV_SYN, 8, 0);
+	add_item(1, 10, -1);
+	end_frame();
+	add_event(EV_REL, REL_WHEEL, -1);
+	add_event(EV_SYN, 8, 0);
+	before = test_num_events;
+
+	run_coalesce(&merged, &frames);
+
+	g_assert_cmpint(merged, ==, 0);
+	g_assert_cmpint(frames, ==, 3);
+	g_assert_cmpint(test_num_events, ==, before);
+}
+
+//
+// With delta frames a finger that came to rest is only marked unchanged; the
+// move that took it there is kept, only a later move drops the markers.
+static void test_unchanged_markers(void)
+{
+	unsigned long merged = 0;
+	int x[8], frames;
+
+	test_num_events = 0;
+	add_item(1, 10, -1);
+	add_item(2, 100, -1);
+	end_frame();
+	add_item(1, 20, -1);
+	add_item(2, 110, -1);
+	end_frame();
+	add_unchanged(1);
+	add_item(2, 120, -1);
+	end_frame();
+	add_unchanged(1);
+	add_item(2, 130, -1);
+	end_frame();
+
+	run_coalesce(&merged, &frames);
+
+	g_assert_cmpint(merged, ==, 4);
+	g_assert_cmpint(frames, ==, 3);
+	g_assert_cmpint(items_of(1, x, 8), ==, 1);
+	g_assert_cmpint(x[0], ==, 20);
+	g_assert_cmpint(unchanged_of(1), ==, 2);
+	g_assert_cmpint(items_of(2, x, 8), ==, 1);
+	g_assert_cmpint(x[0], ==, 130);
+
+	/* the finger moves on, the markers in between go away */
+	add_item(1, 30, -1);
+	end_frame();
+
+	merged = 0;
+	run_coalesce(&merged, &frames);
+
+	g_assert_cmpint(merged, ==, 3);
+	g_assert_cmpint(items_of(1, x, 8), ==, 1);
+	g_assert_cmpint(x[0], ==, 30);
+	g_assert_cmpint(unchanged_of(1), ==, 0);
+	g_assert_cmpint(items_of(2, x, 8), ==, 1);
+	g_assert_cmpint(x[0], ==, 130);
+}
+
+static void add_gesture(multi_finger_state_t state, int scale)
+{
+	add_event(EV_GESTURE, GESTURE_STATE, state);
+	add_event(EV_GESTURE, GESTURE_FINGERS, 2);
+	add_event(EV_GESTURE, GESTURE_SCALE, scale);
+}
+
+static int count_gesture(multi_finger_state_t state)
+{
+	int i, n = 0;
+
+	for (i = 0; i < test_num_events; i++)
+	{
+		n += test_events[i].type == EV_GESTURE &&
+		     test_events[i].code == GESTURE_STATE && test_events[i].value == state;
+	}
+
+	return n;
+}
+
+//
+// Gesture updates collapse like moves, the begin and end stay; the gesture
+// never goes down with the item of the last finger in its frame.
+static void test_gesture_updates(void)
+{
+	unsigned long merged = 0;
+	int x[8], frames, i;
+
+	test_num_events = 0;
+	add_item(1, 0, 1);
+	add_item(2, 100, 1);
+	add_gesture(MULTI_FINGER_BEGIN, 1000);
+	end_frame();
+
+	for (i = 1; i <= 3; i++)
+	{
+		add_item(1, -10 * i, -1);
+		add_item(2, 100 + 10 * i, -1);
+		add_gesture(MULTI_FINGER_UPDATE, 1000 + 200 * i);
+		end_frame();
+	}
+
+	add_item(2, 130, 0);
+	add_gesture(MULTI_FINGER_END, 1600);
+	end_frame();
+
+	run_coalesce(&merged, &frames);
+
+	g_assert_cmpint(merged, ==, 6);
+	g_assert_cmpint(frames, ==, 3);
+	g_assert_cmpint(count_gesture(MULTI_FINGER_BEGIN), ==, 1);
+	g_assert_cmpint(count_gesture(MULTI_FINGER_UPDATE), ==, 1);
+	g_assert_cmpint(count_gesture(MULTI_FINGER_END), ==, 1);
+	g_assert_cmpint(test_events[test_num_events - 2].value, ==, 1600);
+	g_assert_cmpint(items_of(1, x, 8), ==, 2);
+	g_assert_cmpint(x[1], ==, -30);
+}
+
+//
+// Set-up GLib, then register and run the tests.
+int main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/touchpanel/coalesce/moves_collapse", test_moves_collapse);
+	g_test_add_func("/touchpanel/coalesce/transitions_kept",
+	                test_transitions_kept);
+	g_test_add_func("/touchpanel/coalesce/independent_fingers",
+	                test_independent_fingers);
+	g_test_add_func("/touchpanel/coalesce/other_events_untouched",
+	                test_other_events_untouched);
+	g_test_add_func("/touchpanel/coalesce/gesture_updates",
+	                test_gesture_updates);
+	g_test_add_func("/touchpanel/coalesce/unchanged_markers",
+	                test_unchanged_markers);
+
+	return g_test_run();
+}
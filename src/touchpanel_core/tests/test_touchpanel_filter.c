@@ -0,0 +1,131 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef g_assert_true
+#define g_assert_true(X) g_assert((X))
+#endif
+
+//*****************************************************************************
+//*****************************************************************************
+
+// Pull in the unit under test
+#include "../touchpanel_filter.c"
+
+//*****************************************************************************
+//*****************************************************************************
+
+#define TEST_PERIOD_NS  8333333LL
+
+static general_settings_t test_settings =
+{
+	.positionFilter = 1,
+	.filterMinCutoff = 1.0,
+	.filterBeta = 0.1,
+	.filterDCutoff = 1.0
+};
+
+static position_filter_t test_filter;
+
+static void set_time(time_stamp_t *t, int64_t ns)
+{
+	t->time.tv_sec = ns / 1000000000LL;
+	t->time.tv_nsec = ns % 1000000000LL;
+}
+
+//
+// Filter sample i of a 120Hz stream, returns the filtered x
+//
+static int filter_sample(int i, int x, int y)
+{
+	time_stamp_t t;
+
+	set_time(&t, 1000000000LL + i * TEST_PERIOD_NS);
+	position_filter_apply(&test_filter, &test_settings, &x, &y, &t);
+
+	return x;
+}
+
+//
+// The first sample after a reset passes unchanged.
+static void test_reset(void)
+{
+	position_filter_reset(&test_filter);
+	g_assert_cmpint(filter_sample(0, 100, 200), ==, 100);
+	g_assert_cmpint(filter_sample(1, 110, 200), <, 110);
+
+	position_filter_reset(&test_filter);
+	g_assert_cmpint(filter_sample(2, 500, 200), ==, 500);
+}
+
+//
+// A resting finger with +-3 pixels of sensor noise stays within a pixel.
+static void test_jitter_at_rest(void)
+{
+	int i, x, min = 500, max = 500;
+
+	srand(1);
+	position_filter_reset(&test_filter);
+	filter_sample(0, 500, 300);
+
+	for (i = 1; i < 240; i++)
+	{
+		x = filter_sample(i, 500 + rand() % 7 - 3, 300);
+
+		if (i > 60)
+		{
+			min = x < min ? x : min;
+			max = x > max ? x : max;
+		}
+	}
+
+	g_assert_cmpint(min, >=, 499);
+	g_assert_cmpint(max, <=, 501);
+}
+
+//
+// A fast swipe, 3000 pixels per second, trails by less than a millisecond
+// worth of motion once the filter opened up.
+static void test_fast_swipe(void)
+{
+	int i, x = 0;
+
+	position_filter_reset(&test_filter);
+
+	for (i = 0; i < 30; i++)
+	{
+		x = filter_sample(i, 25 * i, 300);
+	}
+
+	g_assert_cmpint(25 * (i - 1) - x, <=, 3);
+	g_assert_cmpint(25 * (i - 1) - x, >=, 0);
+}
+
+//
+// Set-up GLib, then register and run the tests.
+int main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/touchpanel/filter/reset", test_reset);
+	g_test_add_func("/touchpanel/filter/jitter_at_rest", test_jitter_at_rest);
+	g_test_add_func("/touchpanel/filter/fast_swipe", test_fast_swipe);
+
+	return g_test_run();
+}
@@ -0,0 +1,606 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <glib.h>
+#include <stdio.h>
+
+#ifndef g_assert_true
+#define g_assert_true(X) g_assert((X))
+#endif
+
+#ifndef g_assert_false
+#define g_assert_false(X) g_assert(!(X))
+#endif
+
+//
+// Pull in the relevant nyx headers so the logging macros can be redefined
+// before the unit under test is included.
+//
+#include <nyx/nyx_module.h>
+#include <nyx/module/nyx_log.h>
+
+//
+// Mock out all the calls to nyx-lib
+//
+#undef nyx_info
+#define nyx_info(m, args...) {}
+#undef nyx_debug
+#define nyx_debug(m, args...) {}
+#undef nyx_error
+#define nyx_error(m, args...) {}
+
+//*****************************************************************************
+//*****************************************************************************
+
+// Pull in the unit under test
+#include "../../utils/evdev_mask.c"
+#include "../touchpanel_common.c"
+#include "../touchpanel_gestures.c"
+#include "../touchpanel_filter.c"
+#include "../touchpanel_multifinger.c"
+#include "../touchpanel_resample.c"
+
+//*****************************************************************************
+//*****************************************************************************
+
+#define TEST_MAX_FINGERS    5
+#define TEST_MAX_EVENTS     64
+
+static general_settings_t test_settings =
+{
+	.coordBufSize = 6,
+	.fingerDownThreshold = 0,
+	.positionFilter = 0
+};
+
+static input_event_t test_events[TEST_MAX_EVENTS];
+static int test_num_events;
+
+static time_stamp_t test_time;
+
+static void test_setup(void)
+{
+	init_gesture_state_machine(&test_settings, TEST_MAX_FINGERS);
+	test_time.time.tv_sec = 1;
+	test_time.time.tv_nsec = 0;
+}
+
+static void test_teardown(void)
+{
+	deinit_gesture_state_machine();
+}
+
+static void run_device_frame(int device, int *x, int *y, int count)
+{
+	int weights[TEST_MAX_FINGERS] = { 1, 1, 1, 1, 1 };
+
+	test_time.time.tv_nsec += 8000000;
+	test_num_events = 0;
+	gesture_state_machine(device, x, y, weights, count, &test_time, test_events,
+	                      TEST_MAX_EVENTS, &test_num_events);
+}
+
+static void run_frame(int *x, int *y, int count)
+{
+	run_device_frame(0, x, y, count);
+}
+
+//
+// Find the reported ABS_X of a finger in the last frame, -1 if absent
+//
+static int finger_x(uint32_t id)
+{
+	int i;
+
+	for (i = 0; i < test_num_events; i++)
+	{
+		if (test_events[i].type == EV_FINGERID && test_events[i].value == id)
+		{
+			for (i++; i < test_num_events && test_events[i].type != EV_FINGERID; i++)
+			{
+				if (test_events[i].type == EV_ABS && test_events[i].code == ABS_X)
+				{
+					return test_events[i].value;
+				}
+			}
+		}
+	}
+
+	return -1;
+}
+
+static int count_events(uint16_t type, uint16_t code, int32_t value)
+{
+	int i, n = 0;
+
+	for (i = 0; i < test_num_events; i++)
+	{
+		if (test_events[i].type == type && test_events[i].code == code &&
+		        test_events[i].value == value)
+		{
+			n++;
+		}
+	}
+
+	return n;
+}
+
+//
+// Two fingers moving to the right: a greedy nearest-finger match would
+// swap them, the optimal assignment keeps their identities.
+//
+static void test_optimal_assignment(void)
+{
+	int x[2], y[2] = { 100, 100 };
+	uint32_t left, right;
+
+	test_setup();
+
+	x[0] = 0;
+	x[1] = 10;
+	run_frame(x, y, 2);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 1), ==, 2);
+
+	left = test_events[0].value;
+	g_assert_cmpint(finger_x(left), ==, 0);
+	right = left + 1;
+	g_assert_cmpint(finger_x(right), ==, 10);
+
+	x[0] = 6;
+	x[1] = 20;
+	run_frame(x, y, 2);
+	g_assert_cmpint(finger_x(left), ==, 6);
+	g_assert_cmpint(finger_x(right), ==, 20);
+
+	// Same positions, reported in the opposite order
+	x[0] = 21;
+	x[1] = 7;
+	run_frame(x, y, 2);
+	g_assert_cmpint(finger_x(left), ==, 7);
+	g_assert_cmpint(finger_x(right), ==, 21);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 0);
+
+	test_teardown();
+}
+
+//
+// Fingers without a matching point are released, extra points start
+// new fingers.
+//
+static void test_release_and_new_finger(void)
+{
+	int x[3] = { 100, 500, 900 }, y[3] = { 100, 100, 100 };
+	uint32_t first;
+
+	test_setup();
+
+	run_frame(x, y, 2);
+	first = test_events[0].value;
+
+	x[0] = 505;
+	run_frame(x, y, 1);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 1);
+	g_assert_cmpint(finger_x(first + 1), ==, 505);
+
+	x[0] = 510;
+	x[1] = 900;
+	run_frame(x, y, 2);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 1), ==, 1);
+	g_assert_cmpint(finger_x(first + 1), ==, 510);
+	g_assert_cmpint(finger_x(first + 2), ==, 900);
+
+	run_frame(x, y, 0);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 2);
+
+	test_teardown();
+}
+
+//
+// Slot based callers drive fingers directly; a finger stays down as long as
+// it is updated with a non-zero weight.
+//
+static void test_slot_driven_fingers(void)
+{
+	finger_t *finger;
+	int i;
+
+	test_setup();
+
+	finger = add_new_finger(10, 20, 1, &test_time);
+	g_assert_true(finger != NULL);
+
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+	                              &test_num_events);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 1), ==, 1);
+
+	for (i = 0; i < 3; i++)
+	{
+		update_finger(finger, 11 + i, 20, 1, &test_time);
+		test_num_events = 0;
+		gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+		                              &test_num_events);
+		g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 0);
+		g_assert_cmpint(finger_x(finger->id), ==, 11 + i);
+	}
+
+	update_finger(finger, 13, 20, 0, &test_time);
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+	                              &test_num_events);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 1);
+
+	test_teardown();
+}
+
+//
+// With resampling enabled a moving finger is reported one frame ahead, with
+// its velocity, stamped with the target time; the lift off is not predicted.
+//
+static void test_resampled_report(void)
+{
+	finger_t *finger;
+	int i, j;
+
+	test_settings.resample = true;
+	test_settings.resampleOffset = 8000;
+	test_settings.maxPrediction = 8000;
+	test_setup();
+
+	finger = add_new_finger(100, 20, 1, &test_time);
+
+	for (i = 1; i <= 4; i++)
+	{
+		test_time.time.tv_nsec += 8000000;
+		update_finger(finger, 100 + 40 * i, 20, 1, &test_time);
+		test_num_events = 0;
+		gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+		                              &test_num_events);
+	}
+
+	g_assert_cmpint(finger_x(finger->id), ==, 100 + 40 * 5);
+	g_assert_cmpint(count_events(EV_ABS, ABS_VELOCITY_X, 5000), ==, 1);
+	g_assert_cmpint(count_events(EV_ABS, ABS_VELOCITY_Y, 0), ==, 1);
+
+	for (j = 0; j < test_num_events - 1; j++)
+	{
+		g_assert_cmpint(test_events[j].time.tv_usec, ==,
+		                test_time.time.tv_nsec / 1000 + 8000);
+	}
+
+	update_finger(finger, 260, 20, 0, &test_time);
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+	                              &test_num_events);
+	g_assert_cmpint(finger_x(finger->id), ==, 260);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 1);
+
+	test_teardown();
+	test_settings.resample = false;
+	test_settings.resampleOffset = 0;
+}
+
+//
+// A frame that does not fit the event buffer is never written past its end;
+// the fingers left out are reported, and released, with the next frame.
+//
+static void test_event_overflow(void)
+{
+	finger_t *fingers[3];
+	int i, room = 2 * MAX_EVENTS_PER_FINGER + 1;
+
+	test_setup();
+
+	for (i = 0; i < 3; i++)
+	{
+		fingers[i] = add_new_finger(10 * i, 20, 1, &test_time);
+	}
+
+	/* a guard entry past the room given to the state machine */
+	memset(test_events, 0, sizeof(test_events));
+	test_events[room].type = 0xbeef;
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, room, &test_num_events);
+	g_assert_cmpint(test_num_events, <=, room);
+	g_assert_cmpint(test_events[room].type, ==, 0xbeef);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 1), ==, 2);
+	g_assert_cmpint(finger_x(fingers[2]->id), ==, -1);
+
+	for (i = 0; i < 3; i++)
+	{
+		update_finger(fingers[i], 10 * i, 20, 0, &test_time);
+	}
+
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+	                              &test_num_events);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 1), ==, 1);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 3);
+	g_assert_cmpint(sFingerTable.numActive, ==, 0);
+
+	test_teardown();
+}
+
+//
+// With delta frames a resting finger is left out of the frame while a moving
+// one is still reported; the resting one is only marked as unchanged.
+//
+static void test_delta_frames(void)
+{
+	finger_t *resting, *moving;
+
+	test_settings.deltaFrames = true;
+	test_setup();
+
+	resting = add_new_finger(10, 20, 1, &test_time);
+	moving = add_new_finger(100, 20, 1, &test_time);
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+	                              &test_num_events);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 1), ==, 2);
+	g_assert_cmpint(count_events(EV_FINGERID, FINGER_UNCHANGED,
+	                             FINGER_ID(resting)), ==, 0);
+
+	update_finger(resting, 10, 20, 1, &test_time);
+	update_finger(moving, 110, 20, 1, &test_time);
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+	                              &test_num_events);
+	g_assert_cmpint(finger_x(resting->id), ==, -1);
+	g_assert_cmpint(finger_x(moving->id), ==, 110);
+	g_assert_cmpint(count_events(EV_FINGERID, FINGER_UNCHANGED,
+	                             FINGER_ID(resting)), ==, 1);
+	g_assert_cmpint(count_events(EV_FINGERID, FINGER_UNCHANGED,
+	                             FINGER_ID(moving)), ==, 0);
+	/* the marker is the only event of the resting finger */
+	g_assert_cmpint(test_num_events, ==, 1 + 5 + 1);
+
+	/* nothing changed at all, no frame */
+	update_finger(resting, 10, 20, 1, &test_time);
+	update_finger(moving, 110, 20, 1, &test_time);
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+	                              &test_num_events);
+	g_assert_cmpint(test_num_events, ==, 0);
+	g_assert_cmpuint(gesture_state_machine_unchanged(), ==, 3);
+
+	/* the lift off is always reported */
+	update_finger(resting, 10, 20, 0, &test_time);
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+	                              &test_num_events);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 1);
+	g_assert_cmpint(finger_x(moving->id), ==, -1);
+	g_assert_cmpint(count_events(EV_FINGERID, FINGER_UNCHANGED,
+	                             FINGER_ID(moving)), ==, 1);
+	g_assert_cmpint(count_events(EV_SYN, 0, 0), ==, 1);
+
+	test_teardown();
+	test_settings.deltaFrames = false;
+}
+
+//
+// A filtered finger that comes to rest keeps being reported while the filter
+// catches up with it, and is only left out of delta frames once its reported
+// position stops changing.
+//
+static void process_frame(finger_t *finger, int x)
+{
+	test_time.time.tv_nsec += 8000000;
+	update_finger(finger, x, 20, 1, &test_time);
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+	                              &test_num_events);
+}
+
+static void test_delta_frames_filtered(void)
+{
+	finger_t *finger;
+	int x, lastX, frames;
+
+	test_settings.deltaFrames = true;
+	test_settings.positionFilter = 1;
+	test_settings.filterMinCutoff = 1.0;
+	test_settings.filterBeta = 0.0;
+	test_settings.filterDCutoff = 1.0;
+	test_setup();
+
+	finger = add_new_finger(0, 20, 1, &test_time);
+	test_num_events = 0;
+	gesture_state_machine_process(&test_time, test_events, TEST_MAX_EVENTS,
+	                              &test_num_events);
+
+	/* the finger jumps and rests, the filter lags behind */
+	process_frame(finger, 100);
+	lastX = finger_x(finger->id);
+	g_assert_cmpint(lastX, >, 0);
+	g_assert_cmpint(lastX, <, 100);
+
+	for (frames = 0; frames < 1000 && lastX != 100; frames++)
+	{
+		process_frame(finger, 100);
+		x = finger_x(finger->id);
+
+		if (x != -1)
+		{
+			g_assert_cmpint(x, >, lastX);
+			lastX = x;
+		}
+	}
+
+	g_assert_cmpint(lastX, ==, 100);
+
+	/* caught up, now it is left out */
+	process_frame(finger, 100);
+	g_assert_cmpint(test_num_events, ==, 0);
+
+	test_teardown();
+	test_settings.positionFilter = 0;
+	test_settings.deltaFrames = false;
+}
+
+//
+// Points from one device never match, or release, fingers of another and
+// the reported finger ids carry the device index.
+//
+static void test_multiple_devices(void)
+{
+	int x[1] = { 100 }, y[1] = { 100 };
+	uint32_t touch, pen;
+
+	test_setup();
+
+	run_device_frame(0, x, y, 1);
+	touch = test_events[0].value;
+	g_assert_cmpuint(touch >> FINGER_ID_DEVICE_SHIFT, ==, 0);
+
+	x[0] = 102;
+	run_device_frame(1, x, y, 1);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 1), ==, 1);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 0);
+	pen = (1u << FINGER_ID_DEVICE_SHIFT) | (touch + 1);
+	g_assert_cmpint(finger_x(touch), ==, 100);
+	g_assert_cmpint(finger_x(pen), ==, 102);
+
+	// The touchscreen lifts, the pen stays down
+	run_device_frame(0, x, y, 0);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 1);
+	g_assert_cmpint(finger_x(pen), ==, 102);
+
+	x[0] = 104;
+	run_device_frame(1, x, y, 1);
+	g_assert_cmpint(finger_x(pen), ==, 104);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 1), ==, 0);
+	g_assert_cmpint(count_events(EV_KEY, BTN_TOUCH, 0), ==, 0);
+
+	test_teardown();
+}
+
+//
+// The history keeps the last coordBufSize samples while the ring index wraps
+// around its capacity.
+//
+static void test_coord_history(void)
+{
+	finger_t *finger;
+	time_stamp_t last;
+	int i, x, y;
+
+	test_setup();
+
+	finger = add_new_finger(0, 0, 1, &test_time);
+	g_assert_true(finger != NULL);
+
+	for (i = 1; i < 3 * COORD_BUF_CAPACITY; i++)
+	{
+		test_time.time.tv_nsec += 1000000;
+		update_coord_buffer(&finger->coords, i, 2 * i, &test_time);
+	}
+
+	g_assert_cmpint(finger->coords.numItems, ==, test_settings.coordBufSize);
+	get_last_coords(&finger->coords, &x, &y, &last);
+	g_assert_cmpint(x, ==, 3 * COORD_BUF_CAPACITY - 1);
+	g_assert_cmpint(y, ==, 2 * x);
+	g_assert_cmpint(last.time.tv_nsec, ==, test_time.time.tv_nsec);
+
+	x = finger->coords.x[coord_buf_index(&finger->coords,
+	                                     test_settings.coordBufSize - 1)];
+	g_assert_cmpint(x, ==, 3 * COORD_BUF_CAPACITY - test_settings.coordBufSize);
+
+
+	test_teardown();
+}
+
+//
+// Value of an EV_GESTURE code in the last frame, -1 if absent
+//
+static int gesture_value(uint16_t code)
+{
+	int i;
+
+	for (i = 0; i < test_num_events; i++)
+	{
+		if (test_events[i].type == EV_GESTURE && test_events[i].code == code)
+		{
+			return test_events[i].value;
+		}
+	}
+
+	return -1;
+}
+
+//
+// Two fingers pinching out are reported as a gesture ahead of the EV_SYN.
+//
+static void test_multi_finger_gesture(void)
+{
+	int x[2] = { 100, 300 }, y[2] = { 200, 200 };
+
+	test_settings.multiFingerGestures = true;
+	test_setup();
+
+	run_frame(x, y, 1);
+	g_assert_cmpint(gesture_value(GESTURE_STATE), ==, -1);
+
+	run_frame(x, y, 2);
+	g_assert_cmpint(gesture_value(GESTURE_STATE), ==, MULTI_FINGER_BEGIN);
+	g_assert_cmpint(test_events[test_num_events - 1].type, ==, EV_SYN);
+	g_assert_cmpint(gesture_value(GESTURE_CENTER_X), ==, 200);
+
+	x[0] = 0;
+	x[1] = 400;
+	run_frame(x, y, 2);
+	g_assert_cmpint(gesture_value(GESTURE_STATE), ==, MULTI_FINGER_UPDATE);
+	g_assert_cmpint(gesture_value(GESTURE_SCALE), ==, 2000);
+	g_assert_cmpint(gesture_value(GESTURE_ROTATION), ==, 0);
+
+	run_frame(x, y, 1);
+	g_assert_cmpint(gesture_value(GESTURE_STATE), ==, MULTI_FINGER_END);
+	g_assert_cmpint(gesture_value(GESTURE_FINGERS), ==, 1);
+
+	test_teardown();
+	test_settings.multiFingerGestures = false;
+}
+
+//
+// Set-up GLib, then register and run the tests.
+int main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/touchpanel/gestures/optimal_assignment",
+	                test_optimal_assignment);
+	g_test_add_func("/touchpanel/gestures/release_and_new_finger",
+	                test_release_and_new_finger);
+	g_test_add_func("/touchpanel/gestures/slot_driven_fingers",
+	                test_slot_driven_fingers);
+	g_test_add_func("/touchpanel/gestures/resampled_report",
+	                test_resampled_report);
+	g_test_add_func("/touchpanel/gestures/event_overflow",
+	                test_event_overflow);
+	g_test_add_func("/touchpanel/gestures/delta_frames",
+	                test_delta_frames);
+	g_test_add_func("/touchpanel/gestures/delta_frames_filtered",
+	                test_delta_frames_filtered);
+	g_test_add_func("/touchpanel/gestures/multiple_devices",
+	                test_multiple_devices);
+	g_test_add_func("/touchpanel/gestures/coord_history",
+	                test_coord_history);
+	g_test_add_func("/touchpanel/gestures/multi_finger_gesture",
+	                test_multi_finger_gesture);
+
+	return g_test_run();
+}
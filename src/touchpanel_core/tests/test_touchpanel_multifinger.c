@@ -0,0 +1,170 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <glib.h>
+#include <stdio.h>
+
+#ifndef g_assert_true
+#define g_assert_true(X) g_assert((X))
+#endif
+
+#ifndef g_assert_false
+#define g_assert_false(X) g_assert(!(X))
+#endif
+
+//*****************************************************************************
+//*****************************************************************************
+
+// Pull in the unit under test
+#include "../touchpanel_multifinger.c"
+
+//*****************************************************************************
+//*****************************************************************************
+
+static multi_finger_tracker_t test_tracker;
+static multi_finger_gesture_t test_gesture;
+static const uint32_t test_ids[3] = { 1, 2, 3 };
+
+static bool run_frame(const int *x, const int *y, int count)
+{
+	return multi_finger_update(&test_tracker, x, y, test_ids, count,
+	                           &test_gesture);
+}
+
+//
+// A single finger is no gesture; a second one begins it, fingers resting in
+// place report nothing, lifting one ends it.
+static void test_begin_end(void)
+{
+	int x[2] = { 100, 300 }, y[2] = { 200, 200 };
+
+	multi_finger_reset(&test_tracker);
+	g_assert_false(run_frame(x, y, 1));
+
+	g_assert_true(run_frame(x, y, 2));
+	g_assert_cmpint(test_gesture.state, ==, MULTI_FINGER_BEGIN);
+	g_assert_cmpint(test_gesture.fingers, ==, 2);
+	g_assert_cmpint(test_gesture.centerX, ==, 200);
+	g_assert_cmpint(test_gesture.centerY, ==, 200);
+	g_assert_cmpint(test_gesture.scale, ==, 1000);
+	g_assert_cmpint(test_gesture.rotation, ==, 0);
+
+	g_assert_false(run_frame(x, y, 2));
+
+	g_assert_true(run_frame(x, y, 1));
+	g_assert_cmpint(test_gesture.state, ==, MULTI_FINGER_END);
+	g_assert_cmpint(test_gesture.fingers, ==, 1);
+	g_assert_false(run_frame(x, y, 1));
+}
+
+//
+// Fingers moving apart scale, moving together pan, turning rotate.
+static void test_pinch_pan_rotate(void)
+{
+	int x[2] = { 100, 300 }, y[2] = { 200, 200 };
+
+	multi_finger_reset(&test_tracker);
+	run_frame(x, y, 2);
+
+	x[0] = 0;
+	x[1] = 400;
+	g_assert_true(run_frame(x, y, 2));
+	g_assert_cmpint(test_gesture.state, ==, MULTI_FINGER_UPDATE);
+	g_assert_cmpint(test_gesture.scale, ==, 2000);
+	g_assert_cmpint(test_gesture.panX, ==, 0);
+
+	x[0] += 50;
+	x[1] += 50;
+	y[0] += 20;
+	y[1] += 20;
+	g_assert_true(run_frame(x, y, 2));
+	g_assert_cmpint(test_gesture.scale, ==, 2000);
+	g_assert_cmpint(test_gesture.panX, ==, 50);
+	g_assert_cmpint(test_gesture.panY, ==, 20);
+
+	/* quarter turn around the centroid, clockwise on screen */
+	x[0] = 250;
+	x[1] = 250;
+	y[0] = 20;
+	y[1] = 420;
+	g_assert_true(run_frame(x, y, 2));
+	g_assert_cmpint(test_gesture.rotation, ==, 9000);
+	g_assert_cmpint(test_gesture.scale, ==, 2000);
+	g_assert_cmpint(test_gesture.panX, ==, 50);
+}
+
+//
+// The angle is unwrapped: one and a half turns, in eighths, add up.
+static void test_rotation_wraps(void)
+{
+	int x[2], y[2];
+	int i;
+
+	multi_finger_reset(&test_tracker);
+
+	for (i = 0; i <= 12; i++)
+	{
+		double a = i * M_PI / 4;
+
+		x[0] = (int)lround(500 - 100 * cos(a));
+		y[0] = (int)lround(500 - 100 * sin(a));
+		x[1] = (int)lround(500 + 100 * cos(a));
+		y[1] = (int)lround(500 + 100 * sin(a));
+		run_frame(x, y, 2);
+	}
+
+	g_assert_cmpint(test_gesture.rotation, ==, 54000);
+}
+
+//
+// A third finger joining moves the reference instead of making the centroid
+// and spread jump.
+static void test_finger_joins(void)
+{
+	int x[3] = { 100, 300, 200 }, y[3] = { 200, 200, 500 };
+
+	multi_finger_reset(&test_tracker);
+	run_frame(x, y, 2);
+
+	g_assert_true(run_frame(x, y, 3));
+	g_assert_cmpint(test_gesture.state, ==, MULTI_FINGER_UPDATE);
+	g_assert_cmpint(test_gesture.fingers, ==, 3);
+	g_assert_cmpint(test_gesture.scale, ==, 1000);
+	g_assert_cmpint(test_gesture.panX, ==, 0);
+	g_assert_cmpint(test_gesture.panY, ==, 0);
+
+	y[0] += 30;
+	y[1] += 30;
+	y[2] += 30;
+	g_assert_true(run_frame(x, y, 3));
+	g_assert_cmpint(test_gesture.panY, ==, 30);
+}
+
+//
+// Set-up GLib, then register and run the tests.
+int main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/touchpanel/multifinger/begin_end", test_begin_end);
+	g_test_add_func("/touchpanel/multifinger/pinch_pan_rotate",
+	                test_pinch_pan_rotate);
+	g_test_add_func("/touchpanel/multifinger/rotation_wraps",
+	                test_rotation_wraps);
+	g_test_add_func("/touchpanel/multifinger/finger_joins", test_finger_joins);
+
+	return g_test_run();
+}
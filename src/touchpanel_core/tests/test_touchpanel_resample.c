@@ -0,0 +1,225 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <glib.h>
+#include <stdio.h>
+
+#ifndef g_assert_true
+#define g_assert_true(X) g_assert((X))
+#endif
+
+#ifndef g_assert_false
+#define g_assert_false(X) g_assert(!(X))
+#endif
+
+//*****************************************************************************
+//*****************************************************************************
+
+// Pull in the unit under test
+#include "../touchpanel_resample.c"
+
+//*****************************************************************************
+//*****************************************************************************
+
+#define TEST_BUF_SIZE   6
+#define TEST_PERIOD_NS  8000000LL
+
+static coord_buf_t test_buf;
+
+static general_settings_t test_settings =
+{
+	.coordBufSize = TEST_BUF_SIZE,
+	.resample = true,
+	.maxPrediction = 8000
+};
+
+static void set_time(time_stamp_t *t, int64_t ns)
+{
+	t->time.tv_sec = ns / 1000000000LL;
+	t->time.tv_nsec = ns % 1000000000LL;
+}
+
+static int64_t get_time(const time_stamp_t *t)
+{
+	return t->time.tv_sec * 1000000000LL + t->time.tv_nsec;
+}
+
+//
+// Fill the history with samples every 8ms starting at 1s, x(t) = f(i)
+//
+static void fill_history(int count, int (*f)(int))
+{
+	int i;
+
+	test_buf.size = TEST_BUF_SIZE;
+	test_buf.tail = 0;
+	test_buf.numItems = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		unsigned int index = test_buf.tail++ & COORD_BUF_MASK;
+
+		test_buf.x[index] = f(i);
+		test_buf.y[index] = 100;
+		set_time(&test_buf.timeStamp[index], 1000000000LL + i * TEST_PERIOD_NS);
+
+		if (test_buf.numItems < TEST_BUF_SIZE)
+		{
+			test_buf.numItems++;
+		}
+	}
+}
+
+static int linear(int i)
+{
+	return 10 + 40 * i;         /* 5 px per ms */
+}
+
+static int accelerating(int i)
+{
+	return 2 * i * i;           /* 2*(t/8)^2, 1/16 px per ms^2 */
+}
+
+static int64_t newest_time(int count)
+{
+	return 1000000000LL + (count - 1) * TEST_PERIOD_NS;
+}
+
+//
+// Constant speed: one period ahead is one more step, the velocity is exact.
+static void test_extrapolate_linear(void)
+{
+	resampled_coord_t r;
+	time_stamp_t target;
+
+	fill_history(8, linear);
+	set_time(&target, newest_time(8) + TEST_PERIOD_NS);
+
+	g_assert_true(resample_coord_buffer(&test_buf, &target, 8000, &r));
+	g_assert_cmpint(r.x, ==, linear(8));
+	g_assert_cmpint(r.y, ==, 100);
+	g_assert_cmpint(r.xVelocity, ==, 5000);
+	g_assert_cmpint(r.yVelocity, ==, 0);
+	g_assert_cmpint(get_time(&r.timeStamp), ==, get_time(&target));
+}
+
+//
+// The acceleration term of the fit is used for prediction.
+static void test_extrapolate_quadratic(void)
+{
+	resampled_coord_t r;
+	time_stamp_t target;
+
+	fill_history(6, accelerating);
+	set_time(&target, newest_time(6) + TEST_PERIOD_NS);
+
+	g_assert_true(resample_coord_buffer(&test_buf, &target, 8000, &r));
+	g_assert_cmpint(r.x, ==, accelerating(6));
+	/* 4 * 6 / 8 px per ms at the target */
+	g_assert_cmpint(r.xVelocity, ==, 3000);
+}
+
+//
+// Extrapolation stops at maxPrediction past the newest sample.
+static void test_prediction_cap(void)
+{
+	resampled_coord_t r;
+	time_stamp_t target;
+
+	fill_history(4, linear);
+	set_time(&target, newest_time(4) + 50000000LL);
+
+	g_assert_true(resample_coord_buffer(&test_buf, &target, 4000, &r));
+	g_assert_cmpint(r.x, ==, linear(3) + 20);
+	g_assert_cmpint(get_time(&r.timeStamp), ==, newest_time(4) + 4000000LL);
+}
+
+//
+// A target inside the history interpolates between the samples around it.
+static void test_interpolate(void)
+{
+	resampled_coord_t r;
+	time_stamp_t target;
+
+	fill_history(4, linear);
+	set_time(&target, newest_time(4) - 6000000LL);
+
+	g_assert_true(resample_coord_buffer(&test_buf, &target, 8000, &r));
+	g_assert_cmpint(r.x, ==, linear(2) + 10);
+	g_assert_cmpint(r.xVelocity, ==, 5000);
+}
+
+//
+// A single sample is reported as is, an empty history is rejected.
+static void test_single_sample(void)
+{
+	resampled_coord_t r;
+	time_stamp_t target;
+
+	fill_history(1, linear);
+	set_time(&target, newest_time(1) + TEST_PERIOD_NS);
+
+	g_assert_true(resample_coord_buffer(&test_buf, &target, 8000, &r));
+	g_assert_cmpint(r.x, ==, linear(0));
+	g_assert_cmpint(r.xVelocity, ==, 0);
+
+	fill_history(0, linear);
+	g_assert_false(resample_coord_buffer(&test_buf, &target, 8000, &r));
+}
+
+//
+// The target is the next refresh after the frame, plus the offset.
+static void test_vsync_target(void)
+{
+	time_stamp_t frame, target;
+
+	set_time(&frame, 1003000000LL);
+
+	resample_set_vsync(1000000000LL, 10000000LL);
+	test_settings.resampleOffset = 0;
+	resample_get_target(&test_settings, &frame, &target);
+	g_assert_cmpint(get_time(&target), ==, 1010000000LL);
+
+	test_settings.resampleOffset = -2000;
+	resample_get_target(&test_settings, &frame, &target);
+	g_assert_cmpint(get_time(&target), ==, 1008000000LL);
+
+	/* without a known refresh the configured period is used from time 0 */
+	resample_set_vsync(0, 0);
+	test_settings.resampleOffset = 0;
+	test_settings.vsyncPeriod = 4000;
+	resample_get_target(&test_settings, &frame, &target);
+	g_assert_cmpint(get_time(&target), ==, 1004000000LL);
+	test_settings.vsyncPeriod = 0;
+}
+
+//
+// Set-up GLib, then register and run the tests.
+int main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/touchpanel/resample/extrapolate_linear",
+	                test_extrapolate_linear);
+	g_test_add_func("/touchpanel/resample/extrapolate_quadratic",
+	                test_extrapolate_quadratic);
+	g_test_add_func("/touchpanel/resample/prediction_cap", test_prediction_cap);
+	g_test_add_func("/touchpanel/resample/interpolate", test_interpolate);
+	g_test_add_func("/touchpanel/resample/single_sample", test_single_sample);
+	g_test_add_func("/touchpanel/resample/vsync_target", test_vsync_target);
+
+	return g_test_run();
+}
@@ -0,0 +1,216 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file touchpanel_coalesce.c
+ *
+ * @brief Collapse queued finger moves to the latest position
+ *
+ * The event list is a sequence of frames, each made of one item per finger
+ * (EV_FINGERID followed by its events) and closed by an EV_SYN. An item
+ * without BTN_TOUCH is a move. When the consumer falls behind, every move
+ * of a finger that is followed by another move of the same finger, with no
+ * down or up in between, is dropped. A multi-finger gesture update (the
+ * EV_GESTURE events ending a frame) followed by another update is dropped
+ * the same way, its values are relative to the gesture start. Frames left
+ * without items are dropped as a whole. Items of other event types (wheel
+ * keys) are never touched.
+ *
+ * A FINGER_UNCHANGED item of delta frames only says the finger is still where
+ * it was last reported. It never counts as a later move, which would drop the
+ * move that took the finger there, and it is dropped itself when the finger
+ * moves again later.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "touchpanel_coalesce.h"
+#include "touchpanel_multifinger.h"
+
+/* type given to events dropped by the backward pass */
+#define EV_COALESCED    0xffff
+
+static int
+find_finger(const coalesce_scratch_t *pScratch, int numFingers, uint32_t id)
+{
+	int i;
+
+	for (i = 0; i < numFingers; i++)
+	{
+		if (pScratch->fingers[i] == id)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ *******************************************************************************
+ * @brief Coalesce the moves queued in an event list
+ *
+ * @param  events       IN/OUT  events of complete frames, compacted in place
+ * @param  numEvents    IN      number of events
+ * @param  pScratch     IN      scratch space; fingers beyond maxFingers are
+ *                              left alone, frames beyond maxFrames not mapped
+ * @param  pNumFrames   OUT     number of frames kept, framesKept[i] holds the
+ *                              original index of the i-th one
+ * @param  pMerged      IN/OUT  incremented by the number of items dropped
+ *
+ * @retval number of events left
+ *******************************************************************************
+ */
+int
+coalesce_moves(input_event_t *events, int numEvents,
+               coalesce_scratch_t *pScratch, int *pNumFrames,
+               unsigned long *pMerged)
+{
+	int numFingers = 0, end = numEvents, frameEnd = numEvents;
+	int i, n, frame, numFrames, dropped;
+	bool hasItems, laterUpdate = false;
+
+	/*
+	 * Walk the items from the newest backwards, remembering which fingers
+	 * have a later move. A down or up ends a run of moves.
+	 */
+	for (i = numEvents - 1; i >= 0; i--)
+	{
+		bool transition = false;
+		int j, found;
+
+		if (events[i].type == EV_SYN)
+		{
+			end = i;
+			frameEnd = i;
+			continue;
+		}
+
+		if (events[i].type == EV_GESTURE)
+		{
+			end = i;
+
+			if (events[i].code != GESTURE_STATE)
+			{
+				continue;
+			}
+
+			/* the gesture events run up to the EV_SYN */
+			if (events[i].value != MULTI_FINGER_UPDATE)
+			{
+				laterUpdate = false;
+			}
+			else if (laterUpdate)
+			{
+				for (j = i; j < frameEnd; j++)
+				{
+					events[j].type = EV_COALESCED;
+				}
+
+				(*pMerged)++;
+			}
+			else
+			{
+				laterUpdate = true;
+			}
+
+			continue;
+		}
+
+		if (events[i].type != EV_FINGERID)
+		{
+			continue;
+		}
+
+		for (j = i + 1; j < end; j++)
+		{
+			if (events[j].type == EV_KEY && events[j].code == BTN_TOUCH)
+			{
+				transition = true;
+			}
+		}
+
+		found = find_finger(pScratch, numFingers, events[i].value);
+
+		if (transition)
+		{
+			if (found >= 0)
+			{
+				pScratch->fingers[found] = pScratch->fingers[--numFingers];
+			}
+		}
+		else if (found >= 0)
+		{
+			/* a later move supersedes this move or unchanged marker */
+			for (j = i; j < end; j++)
+			{
+				events[j].type = EV_COALESCED;
+			}
+
+			(*pMerged)++;
+		}
+		else if (events[i].code != FINGER_UNCHANGED &&
+		         numFingers < pScratch->maxFingers)
+		{
+			pScratch->fingers[numFingers++] = events[i].value;
+		}
+
+		end = i;
+	}
+
+	/* compact, dropping the frames that lost all of their items */
+	n = 0;
+	frame = 0;
+	numFrames = 0;
+	dropped = 0;
+	hasItems = false;
+
+	for (i = 0; i < numEvents; i++)
+	{
+		if (events[i].type == EV_COALESCED)
+		{
+			dropped++;
+			continue;
+		}
+
+		if (events[i].type == EV_SYN)
+		{
+			if (dropped == 0 || hasItems)
+			{
+				if (numFrames < pScratch->maxFrames)
+				{
+					pScratch->framesKept[numFrames] = frame;
+				}
+
+				numFrames++;
+				events[n++] = events[i];
+			}
+
+			frame++;
+			dropped = 0;
+			hasItems = false;
+			continue;
+		}
+
+		hasItems = true;
+		events[n++] = events[i];
+	}
+
+	*pNumFrames = numFrames;
+
+	return n;
+}
@@ -0,0 +1,36 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __TOUCHPANEL_COALESCE_H
+#define __TOUCHPANEL_COALESCE_H
+
+#include <stdint.h>
+
+#include "touchpanel_gestures.h"
+
+typedef struct coalesce_scratch
+{
+	uint32_t *fingers;      /**< fingers with a later move, maxFingers entries */
+	int maxFingers;
+	int *framesKept;        /**< original index of every frame kept */
+	int maxFrames;
+} coalesce_scratch_t;
+
+int coalesce_moves(input_event_t *events, int numEvents,
+                   coalesce_scratch_t *pScratch, int *pNumFrames,
+                   unsigned long *pMerged);
+
+#endif  /* __TOUCHPANEL_COALESCE_H */
@@ -0,0 +1,100 @@
+// Copyright (c) 2010-2018 LG Electronics, Inc.
+// Copyright (c) 2012 Simon Busch <morphis@gravedo.de>
+// Copyright (c) 2018 Christophe Chapuis <chris.chapuis@gmail.com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "touchpanel_gestures.h"
+#include "touchpanel_common.h"
+#include "evdev_mask.h"
+
+#include <string.h>
+
+#include <nyx/module/nyx_log.h>
+#include "msgid.h"
+
+void
+set_event_params(input_event_t *pEvent, const time_stamp_t *pTime, uint16_t type,
+                 uint16_t code, int32_t value)
+{
+	if (NULL == pEvent || NULL == pTime)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_EVENT_NULL_ERR, 0, "NULL parameter passed");
+		return;
+	}
+
+	pEvent->time.tv_sec = pTime->time.tv_sec;
+	pEvent->time.tv_usec = pTime->time.tv_nsec / 1000;
+
+	pEvent->type = type;
+	pEvent->code = code;
+	pEvent->value = value;
+}
+
+/* qemu sends BTN_TOUCH, virtualbox BTN_LEFT; the rest is forwarded as is */
+static const unsigned int sSingleTouchKeys[] =
+{
+	BTN_TOUCH, BTN_LEFT, BTN_MIDDLE, BTN_SIDE, BTN_EXTRA, BTN_FORWARD, BTN_BACK,
+	BTN_TASK
+};
+
+static const unsigned int sSingleTouchAbs[] = { ABS_X, ABS_Y };
+
+static const unsigned int sSingleTouchRel[] = { REL_WHEEL };
+
+static const evdev_filter_t sSingleTouchFilters[] =
+{
+	{ EV_KEY, sSingleTouchKeys, sizeof(sSingleTouchKeys) / sizeof(sSingleTouchKeys[0]) },
+	{ EV_ABS, sSingleTouchAbs, sizeof(sSingleTouchAbs) / sizeof(sSingleTouchAbs[0]) },
+	{ EV_REL, sSingleTouchRel, sizeof(sSingleTouchRel) / sizeof(sSingleTouchRel[0]) },
+};
+
+int
+filter_single_touch_events(int fd)
+{
+	return evdev_set_filter(fd, sSingleTouchFilters,
+	                        sizeof(sSingleTouchFilters) / sizeof(sSingleTouchFilters[0]));
+}
+
+/*
+ * Optional calibration from the module.touchpanel group of the nyx
+ * configuration file, mapping normalized device coordinates, 0..1 on both
+ * axes, with x' = a*x + b*y + c and y' = d*x + e*y + f, e.g. a rotation by
+ * 90 degrees:
+ *
+ *   [module.touchpanel]
+ *   calibrationMatrix=0;-1;1;1;0;0
+ *
+ * The matrix is left alone if the key is not set or invalid.
+ */
+void
+load_calibration(GKeyFile *keyfile, double *matrix)
+{
+	gsize length = 0;
+	gdouble *values = g_key_file_get_double_list(keyfile, NYX_CONF_GROUP_TOUCHPANEL,
+	                                             "calibrationMatrix", &length, NULL);
+
+	if (values && length == 6)
+	{
+		memcpy(matrix, values, 6 * sizeof(double));
+	}
+	else if (values)
+	{
+		nyx_warn(MSGID_NYX_MOD_TP_CALIBRATION, 0,
+		         "calibrationMatrix needs 6 values, %zu given", (size_t) length);
+	}
+
+	g_free(values);
+}
@@ -19,8 +19,21 @@
 #ifndef __TOUCHPANEL_COMMON_H
 #define __TOUCHPANEL_COMMON_H
 
-void set_event_params(input_event_t *pEvent, time_stamp_t *pTime, uint16_t type,
+#include <glib.h>
+
+#define NYX_CONF_FILE               "/etc/nyx.conf"
+#define NYX_CONF_GROUP_TOUCHPANEL   "module.touchpanel"
+
+void set_event_params(input_event_t *pEvent, const time_stamp_t *pTime, uint16_t type,
                       uint16_t code, int32_t value);
 
+/*
+ * Have the kernel drop everything but the events the single touch and mouse
+ * handling uses on fd. Returns -1 if the kernel cannot filter.
+ */
+int filter_single_touch_events(int fd);
+
+void load_calibration(GKeyFile *keyfile, double *matrix);
+
 #endif  /* __TOUCHPANEL_COMMON_PRV_H */
 
@@ -0,0 +1,111 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file touchpanel_filter.c
+ *
+ * @brief Speed dependent smoothing of finger positions
+ *
+ * A One Euro filter: a first order low-pass filter whose cutoff frequency
+ * rises with the finger speed, cutoff = filterMinCutoff + filterBeta * speed.
+ * A resting finger is filtered at the low minimum cutoff, which removes the
+ * jitter of the sensor; a fast one at a cutoff high enough that the filter
+ * barely lags behind it. The speed itself is low-pass filtered at
+ * filterDCutoff so noise does not open the filter up.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "touchpanel_filter.h"
+
+#define NSEC_PER_SEC            1000000000LL
+
+/* shortest sample interval used, same timestamps would divide by zero */
+#define FILTER_MIN_PERIOD       0.0001
+
+/* Smoothing factor of an exponential filter at cutoff Hz sampled every dt s */
+static inline double
+smoothing_factor(double cutoff, double dt)
+{
+	double tau = 1.0 / (2.0 * M_PI * cutoff);
+
+	return 1.0 / (1.0 + tau / dt);
+}
+
+/**
+ * @brief Forget the history of a filter, the next sample passes unchanged
+ */
+void
+position_filter_reset(position_filter_t *pFilter)
+{
+	pFilter->primed = false;
+}
+
+/**
+ * @brief Filter a new sample of a finger position in place
+ *
+ * @param  pFilter          IN/OUT  state of the finger's filter
+ * @param  pGeneralSettings IN      filter parameters
+ * @param  pX, pY           IN/OUT  raw position, replaced by the filtered one
+ * @param  pTime            IN      time of the sample
+ */
+void
+position_filter_apply(position_filter_t *pFilter,
+                      const general_settings_t *pGeneralSettings,
+                      int *pX, int *pY, const time_stamp_t *pTime)
+{
+	int64_t now = (int64_t)pTime->time.tv_sec * NSEC_PER_SEC + pTime->time.tv_nsec;
+	double dt, a, dx, dy, cutoff;
+
+	if (!pFilter->primed)
+	{
+		pFilter->x = *pX;
+		pFilter->y = *pY;
+		pFilter->dx = 0;
+		pFilter->dy = 0;
+		pFilter->lastTime = now;
+		pFilter->primed = true;
+		return;
+	}
+
+	dt = (now - pFilter->lastTime) / (double)NSEC_PER_SEC;
+
+	if (dt < FILTER_MIN_PERIOD)
+	{
+		dt = FILTER_MIN_PERIOD;
+	}
+
+	pFilter->lastTime = now;
+
+	/* filtered velocity, pixels per second */
+	dx = (*pX - pFilter->x) / dt;
+	dy = (*pY - pFilter->y) / dt;
+	a = smoothing_factor(pGeneralSettings->filterDCutoff, dt);
+	pFilter->dx += a * (dx - pFilter->dx);
+	pFilter->dy += a * (dy - pFilter->dy);
+
+	/* one cutoff for both axes, so diagonal moves are not bent */
+	cutoff = pGeneralSettings->filterMinCutoff + pGeneralSettings->filterBeta *
+	         hypot(pFilter->dx, pFilter->dy);
+	a = smoothing_factor(cutoff, dt);
+	pFilter->x += a * (*pX - pFilter->x);
+	pFilter->y += a * (*pY - pFilter->y);
+
+	*pX = (int)lround(pFilter->x);
+	*pY = (int)lround(pFilter->y);
+}
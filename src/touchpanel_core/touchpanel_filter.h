@@ -1,4 +1,4 @@
-// Copyright (c) 2010-2018 LG Electronics, Inc.
+// Copyright (c) 2026 agent <agent@local>
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -14,11 +14,14 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
-#ifndef __TOUCHPANEL_COMMON_H
-#define __TOUCHPANEL_COMMON_H
+#ifndef __TOUCHPANEL_FILTER_H
+#define __TOUCHPANEL_FILTER_H
 
-void set_event_params(input_event_t *pEvent, time_stamp_t *pTime, uint16_t type,
-                      uint16_t code, int32_t value);
+#include "touchpanel_gestures.h"
 
-#endif  /* __TOUCHPANEL_COMMON_PRV_H */
+void position_filter_reset(position_filter_t *pFilter);
+void position_filter_apply(position_filter_t *pFilter,
+                           const general_settings_t *pGeneralSettings,
+                           int *pX, int *pY, const time_stamp_t *pTime);
 
+#endif  /* __TOUCHPANEL_FILTER_H */
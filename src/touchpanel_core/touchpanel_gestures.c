@@ -0,0 +1,777 @@
+// Copyright (c) 2010-2018 LG Electronics, Inc.
+// Copyright (c) 2012 Simon Busch <morphis@gravedo.de>
+// Copyright (c) 2018 Christophe Chapuis <chris.chapuis@gmail.com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <glib-2.0/glib.h>
+
+#include <nyx/module/nyx_log.h>
+
+
+#include "touchpanel_gestures.h"
+#include "touchpanel_common.h"
+#include "touchpanel_filter.h"
+#include "touchpanel_multifinger.h"
+#include "touchpanel_resample.h"
+#include "msgid.h"
+
+/*
+ * Fingers live in a fixed-capacity table allocated once at init time, their
+ * coordinate history inline, so tracking a frame does not chase pointers.
+ * Active fingers are kept in arrival order in a dense array, and during
+ * matching their last coordinates are copied into contiguous x/y arrays so
+ * the distance matrix is computed with a straight loop over ints.
+ */
+typedef struct finger_table
+{
+	int capacity;
+	int numActive;
+	int numFree;
+	finger_t *fingers;          /**< backing storage, capacity entries */
+	finger_t **active;          /**< active fingers, oldest first */
+	finger_t **free;            /**< stack of unused fingers */
+	finger_t **candidates;      /**< active fingers of the device being matched */
+	multi_finger_tracker_t gesture;
+
+	/* scratch space for frame matching, sized for capacity x capacity */
+	int *lastX;
+	int *lastY;
+	int *match;                 /**< point index matched to each active finger */
+	uint32_t *ids;
+	bool *pointUsed;
+	int64_t *cost;
+	int64_t *u;
+	int64_t *v;
+	int64_t *minv;
+	int *p;
+	int *way;
+	bool *used;
+
+	unsigned long overflows;    /**< fingers postponed for lack of event room */
+	unsigned long unchanged;    /**< items left out of delta frames */
+} finger_table_t;
+
+static finger_table_t sFingerTable;
+
+static uint32_t curFingerId = 0;
+
+int gesture_state_machine_finger(finger_t *finger, const time_stamp_t *pTarget,
+                                 input_event_t *events, int *numEvents);
+
+static const general_settings_t *spGeneralSettings = NULL;
+
+/**
+ *******************************************************************************
+ * @brief Initialize the ring that keeps a coordinate history
+ *
+ * @param  pCoordBuf    IN/OUT  ptr to the coordinate buffer struct
+ * @param  bufSize      IN      length of the history, 1..COORD_BUF_CAPACITY
+ *******************************************************************************
+ */
+static void
+init_coord_buffer(coord_buf_t *pCoordBuf, int bufSize)
+{
+	pCoordBuf->size = bufSize < 1 ? 1 :
+	                  bufSize > COORD_BUF_CAPACITY ? COORD_BUF_CAPACITY : bufSize;
+	pCoordBuf->tail = 0;
+	pCoordBuf->numItems = 0;
+}
+
+
+void init_gesture_state_machine(const general_settings_t *pGeneralSettings,
+                                int maxFingers)
+{
+	finger_table_t *t = &sFingerTable;
+	int i, n;
+
+	spGeneralSettings = pGeneralSettings;
+
+	n = maxFingers * 2;
+	t->capacity = n;
+	t->numActive = 0;
+	t->numFree = 0;
+	multi_finger_reset(&t->gesture);
+	t->fingers = calloc(n, sizeof(finger_t));
+	t->active = calloc(n, sizeof(finger_t *));
+	t->free = calloc(n, sizeof(finger_t *));
+	t->candidates = calloc(n, sizeof(finger_t *));
+	t->lastX = calloc(n, sizeof(int));
+	t->lastY = calloc(n, sizeof(int));
+	t->match = calloc(n, sizeof(int));
+	t->ids = calloc(n, sizeof(uint32_t));
+	t->pointUsed = calloc(n, sizeof(bool));
+	t->cost = calloc(n * n, sizeof(int64_t));
+	t->u = calloc(n + 1, sizeof(int64_t));
+	t->v = calloc(n + 1, sizeof(int64_t));
+	t->minv = calloc(n + 1, sizeof(int64_t));
+	t->p = calloc(n + 1, sizeof(int));
+	t->way = calloc(n + 1, sizeof(int));
+	t->used = calloc(n + 1, sizeof(bool));
+
+	if (!t->fingers || !t->active || !t->free || !t->candidates || !t->lastX ||
+	        !t->lastY || !t->match || !t->ids || !t->pointUsed || !t->cost || !t->u ||
+	        !t->v || !t->minv || !t->p || !t->way || !t->used)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_COORDS_ERR, 0, "Failed to allocate finger table");
+		deinit_gesture_state_machine();
+		return;
+	}
+
+	/* hand out the lowest table entries first */
+	for (i = n - 1; i >= 0; i--)
+	{
+		finger_t *finger = &t->fingers[i];
+
+		init_coord_buffer(&finger->coords, pGeneralSettings->coordBufSize);
+		finger->state.state = UNUSED;
+		t->free[t->numFree++] = finger;
+	}
+}
+
+
+void
+deinit_gesture_state_machine(void)
+{
+	finger_table_t *t = &sFingerTable;
+
+	if (t->overflows)
+	{
+		nyx_warn(MSGID_NYX_MOD_TP_EVENT_OVERFLOW, 0,
+		         "%lu fingers postponed to a later frame, event buffer too small",
+		         t->overflows);
+	}
+
+	if (t->unchanged)
+	{
+		nyx_info(MSGID_NYX_MOD_TP_DELTA_FRAMES, 0,
+		         "%lu unchanged finger items left out of frames", t->unchanged);
+	}
+
+	free(t->fingers);
+	free(t->active);
+	free(t->free);
+	free(t->candidates);
+	free(t->lastX);
+	free(t->lastY);
+	free(t->match);
+	free(t->ids);
+	free(t->pointUsed);
+	free(t->cost);
+	free(t->u);
+	free(t->v);
+	free(t->minv);
+	free(t->p);
+	free(t->way);
+	free(t->used);
+
+	memset(t, 0, sizeof(*t));
+}
+
+void
+reset_state_data(gesture_state_data_t *pStateData)
+{
+	pStateData->state = START_STATE;
+	pStateData->insideTapRadius = true;
+}
+
+finger_t *add_new_finger(int x, int y, int weight, const time_stamp_t *pCurTime)
+{
+	finger_table_t *t = &sFingerTable;
+	finger_t *finger;
+
+	if (t->numFree == 0)
+	{
+		nyx_info(MSGID_NYX_MOD_TP_NO_FINGER_BUFF, 0, "No available finger buffers, rejecting finger");
+		return NULL;
+	}
+
+	finger = t->free[--t->numFree];
+	reset_state_data(&finger->state);
+	finger->id = curFingerId++ & FINGER_ID_MASK;
+	finger->device = 0;
+	finger->timestamp = *pCurTime;
+	finger->present = true;
+	finger->changed = true;
+	finger->lastWeight = weight;
+	reset_coord_buffer(&finger->coords);
+	position_filter_reset(&finger->filter);
+
+	if (spGeneralSettings->positionFilter)
+	{
+		position_filter_apply(&finger->filter, spGeneralSettings, &x, &y, pCurTime);
+	}
+
+	update_coord_buffer(&finger->coords, x, y, pCurTime);
+	nyx_debug(MSGID_NYX_MOD_TP_FINGER_DOWN, 0, "Finger down at %d,%d", x, y);
+	t->active[t->numActive++] = finger;
+
+	return finger;
+}
+
+static void
+store_finger_coord(finger_t *finger, int x, int y, int weight,
+                   const time_stamp_t *pCurTime)
+{
+	//Let's ignore the coordinate if there was a huge difference in weight
+	//This is a common scenario when the user is releasing his finger.
+	if (finger->lastWeight / 2 < weight)
+	{
+		int lastX, lastY, newX, newY;
+
+		if (spGeneralSettings->positionFilter)
+		{
+			position_filter_apply(&finger->filter, spGeneralSettings, &x, &y,
+			                      pCurTime);
+		}
+
+		/* compare what was stored, the filter may not have moved it */
+		get_last_coords(&finger->coords, &lastX, &lastY, NULL);
+		update_coord_buffer(&finger->coords, x, y, pCurTime);
+		get_last_coords(&finger->coords, &newX, &newY, NULL);
+		finger->changed |= (newX != lastX || newY != lastY);
+	}
+	else
+	{
+		nyx_debug(MSGID_NYX_MOD_TP_IGNORING_COORD, 0, "Ignoring coordinate");
+	}
+}
+
+/*
+ * Feed a new sample for a tracked finger. A zero weight means the contact is
+ * gone and the finger will be released by the next gesture_state_machine_process().
+ */
+void
+update_finger(finger_t *finger, int x, int y, int weight,
+              const time_stamp_t *pCurTime)
+{
+	if (finger == NULL)
+	{
+		return;
+	}
+
+	store_finger_coord(finger, x, y, weight, pCurTime);
+	finger->changed |= finger->present != (weight > 0);
+	finger->present = (weight > 0);
+	finger->lastWeight = weight;
+}
+
+/*
+ * Minimum cost assignment of rows to columns (rows <= cols), Hungarian method
+ * with row/column potentials in O(rows^2 * cols). The cost matrix is stored
+ * row-major with cols entries per row. On return t->p[j] holds the 1-based row
+ * assigned to 1-based column j, or 0 if the column is left unassigned.
+ */
+static void
+assign_min_cost(finger_table_t *t, int rows, int cols)
+{
+	const int64_t *cost = t->cost;
+	int64_t *u = t->u, *v = t->v, *minv = t->minv;
+	int *p = t->p, *way = t->way;
+	bool *used = t->used;
+	int i, j;
+
+	for (j = 0; j <= cols; j++)
+	{
+		v[j] = 0;
+		p[j] = 0;
+		way[j] = 0;
+	}
+
+	for (i = 0; i <= rows; i++)
+	{
+		u[i] = 0;
+	}
+
+	for (i = 1; i <= rows; i++)
+	{
+		int j0 = 0;
+
+		p[0] = i;
+
+		for (j = 0; j <= cols; j++)
+		{
+			minv[j] = INT64_MAX;
+			used[j] = false;
+		}
+
+		do
+		{
+			int i0 = p[j0], j1 = 0;
+			int64_t delta = INT64_MAX;
+
+			used[j0] = true;
+
+			for (j = 1; j <= cols; j++)
+			{
+				if (!used[j])
+				{
+					int64_t cur = cost[(i0 - 1) * cols + (j - 1)] - u[i0] - v[j];
+
+					if (cur < minv[j])
+					{
+						minv[j] = cur;
+						way[j] = j0;
+					}
+
+					if (minv[j] < delta)
+					{
+						delta = minv[j];
+						j1 = j;
+					}
+				}
+			}
+
+			for (j = 0; j <= cols; j++)
+			{
+				if (used[j])
+				{
+					u[p[j]] += delta;
+					v[j] -= delta;
+				}
+				else
+				{
+					minv[j] -= delta;
+				}
+			}
+
+			j0 = j1;
+		}
+		while (p[j0] != 0);
+
+		do
+		{
+			int j1 = way[j0];
+			p[j0] = p[j1];
+			j0 = j1;
+		}
+		while (j0);
+	}
+}
+
+/*
+ * Match fingers against the new input points so that the sum of squared
+ * distances is minimal. On return t->match[i] holds the point index for
+ * finger i, or -1 if the finger has no point left this frame.
+ */
+static void
+match_fingers(finger_table_t *t, finger_t *const *fingers, int numFingers,
+              const int *pXCoords, const int *pYCoords, int numPoints)
+{
+	int i, j;
+
+	for (i = 0; i < numFingers; i++)
+	{
+		t->match[i] = -1;
+		get_last_coords(&fingers[i]->coords, &t->lastX[i], &t->lastY[i], NULL);
+	}
+
+	if (numFingers == 0 || numPoints == 0)
+	{
+		return;
+	}
+
+	/* the solver wants no more rows than columns, transpose if needed */
+	if (numFingers <= numPoints)
+	{
+		for (i = 0; i < numFingers; i++)
+		{
+			int64_t *row = &t->cost[i * numPoints];
+
+			for (j = 0; j < numPoints; j++)
+			{
+				int64_t dx = pXCoords[j] - t->lastX[i];
+				int64_t dy = pYCoords[j] - t->lastY[i];
+				row[j] = dx * dx + dy * dy;
+			}
+		}
+
+		assign_min_cost(t, numFingers, numPoints);
+
+		for (j = 1; j <= numPoints; j++)
+		{
+			if (t->p[j])
+			{
+				t->match[t->p[j] - 1] = j - 1;
+			}
+		}
+	}
+	else
+	{
+		for (j = 0; j < numPoints; j++)
+		{
+			int64_t *row = &t->cost[j * numFingers];
+
+			for (i = 0; i < numFingers; i++)
+			{
+				int64_t dx = pXCoords[j] - t->lastX[i];
+				int64_t dy = pYCoords[j] - t->lastY[i];
+				row[i] = dx * dx + dy * dy;
+			}
+		}
+
+		assign_min_cost(t, numPoints, numFingers);
+
+		for (i = 1; i <= numFingers; i++)
+		{
+			if (t->p[i])
+			{
+				t->match[i - 1] = t->p[i] - 1;
+			}
+		}
+	}
+}
+
+/*
+ * Finger tracking:
+ * The hardware does not do any fingertracking, so we do it all here. The
+ * points only compete for the fingers of the device that reported them.
+ */
+void
+gesture_state_machine(int device, int *pXCoords, int *pYCoords,
+                      const int *pFingerWeights,
+                      int numFingers, const time_stamp_t *pCurTime,
+                      input_event_t *events, int maxEvents, int *numEvents)
+{
+	finger_table_t *t = &sFingerTable;
+	int timestmpcnt = 0;
+	int i, j, numCandidates = 0;
+
+	if (numFingers > t->capacity)
+	{
+		nyx_info(MSGID_NYX_MOD_TP_NO_FINGER_BUFF, 0, "Dropping %d input points over capacity",
+		         numFingers - t->capacity);
+		numFingers = t->capacity;
+	}
+
+	for (i = 0; i < t->numActive; i++)
+	{
+		if (t->active[i]->device == device)
+		{
+			t->candidates[numCandidates++] = t->active[i];
+		}
+	}
+
+	match_fingers(t, t->candidates, numCandidates, pXCoords, pYCoords, numFingers);
+
+	for (j = 0; j < numFingers; j++)
+	{
+		t->pointUsed[j] = false;
+	}
+
+	//Update each of the fingers that has a match with new coordinates,
+	//the others are released when the changes get processed.
+	for (i = 0; i < numCandidates; i++)
+	{
+		finger_t *finger = t->candidates[i];
+		int m = t->match[i];
+
+		if (m < 0)
+		{
+			finger->changed = true;
+			finger->present = false;
+			continue;
+		}
+
+		nyx_debug(MSGID_NYX_MOD_TP_FINGER_WT, 0, "New coord (at: %d), %d,%d weight: %d",
+		          m, pXCoords[m], pYCoords[m], pFingerWeights[m]);
+
+		store_finger_coord(finger, pXCoords[m], pYCoords[m], pFingerWeights[m],
+		                   pCurTime);
+		finger->lastWeight = pFingerWeights[m];
+		finger->present = true;
+		t->pointUsed[m] = true;
+	}
+
+	//Now go through the points and start a finger for any unmatched one
+	for (j = 0; j < numFingers; j++)
+	{
+		time_stamp_t ts = *pCurTime;
+		finger_t *finger;
+
+		if (t->pointUsed[j])
+		{
+			continue;
+		}
+
+		if (pFingerWeights[j] < g_atomic_int_get(
+		            &spGeneralSettings->fingerDownThreshold))
+		{
+			nyx_info(MSGID_NYX_MOD_TP_FING_LOW_WT, 0,"Discarding finger with too low weight (%d)", pFingerWeights[j]);
+			continue;
+		}
+
+		nyx_debug(MSGID_NYX_MOD_TP_FINGER_WT, 0, "pFingerWeight: %d (%d)", pFingerWeights[j], j);
+
+		nyx_debug(MSGID_NYX_MOD_TP_NEW_FINGER, 0, "j: %d, %d) New finger @ %d,%d", j, numFingers, pXCoords[j],
+		         pYCoords[j]);
+
+		ts.time.tv_nsec += timestmpcnt;
+		timestmpcnt += 1000000;
+		finger = add_new_finger(pXCoords[j], pYCoords[j], pFingerWeights[j], &ts);
+
+		if (finger)
+		{
+			finger->device = device;
+		}
+	}
+
+	/* All fingers has been matched, now let's process the changes */
+	gesture_state_machine_process(pCurTime, events, maxEvents, numEvents);
+}
+
+/*
+ * Feed the fingers down on one device, the one of the oldest finger, to the
+ * multi-finger gesture tracker and emit its EV_GESTURE events if the gesture
+ * began, changed or ended.
+ */
+static void
+multi_finger_gesture_state_machine(const time_stamp_t *pCurTime,
+                                   input_event_t *events, int *numEvents)
+{
+	finger_table_t *t = &sFingerTable;
+	multi_finger_gesture_t gesture;
+	int i, n = 0;
+
+	for (i = 0; i < t->numActive; i++)
+	{
+		finger_t *finger = t->active[i];
+
+		if (finger->device != t->active[0]->device)
+		{
+			continue;
+		}
+
+		get_last_coords(&finger->coords, &t->lastX[n], &t->lastY[n], NULL);
+		t->ids[n++] = FINGER_ID(finger);
+	}
+
+	if (!multi_finger_update(&t->gesture, t->lastX, t->lastY, t->ids, n,
+	                         &gesture))
+	{
+		return;
+	}
+
+	set_event_params(&events[(*numEvents)++], pCurTime, EV_GESTURE,
+	                 GESTURE_STATE, gesture.state);
+	set_event_params(&events[(*numEvents)++], pCurTime, EV_GESTURE,
+	                 GESTURE_FINGERS, gesture.fingers);
+	set_event_params(&events[(*numEvents)++], pCurTime, EV_GESTURE,
+	                 GESTURE_CENTER_X, gesture.centerX);
+	set_event_params(&events[(*numEvents)++], pCurTime, EV_GESTURE,
+	                 GESTURE_CENTER_Y, gesture.centerY);
+	set_event_params(&events[(*numEvents)++], pCurTime, EV_GESTURE,
+	                 GESTURE_PAN_X, gesture.panX);
+	set_event_params(&events[(*numEvents)++], pCurTime, EV_GESTURE,
+	                 GESTURE_PAN_Y, gesture.panY);
+	set_event_params(&events[(*numEvents)++], pCurTime, EV_GESTURE,
+	                 GESTURE_SCALE, gesture.scale);
+	set_event_params(&events[(*numEvents)++], pCurTime, EV_GESTURE,
+	                 GESTURE_ROTATION, gesture.rotation);
+}
+
+void
+gesture_state_machine_process(const time_stamp_t *pCurTime,
+                              input_event_t *events, int maxEvents,
+                              int *numEvents)
+{
+	finger_table_t *t = &sFingerTable;
+	time_stamp_t target;
+	int i, ret, kept = 0, unchanged = 0;
+	int reserved = 1;
+	int first = *numEvents;
+
+	if (spGeneralSettings->resample)
+	{
+		resample_get_target(spGeneralSettings, pCurTime, &target);
+	}
+
+	if (spGeneralSettings->multiFingerGestures)
+	{
+		reserved += MAX_EVENTS_PER_GESTURE;
+	}
+
+	/* Let's process the changes, keeping the active array in arrival order */
+	for (i = 0; i < t->numActive; i++)
+	{
+		finger_t *finger = t->active[i];
+
+		/*
+		 * Keep room for the gesture and the EV_SYN. A finger that does not fit
+		 * stays active, unchanged, and is reported (or released) with the next
+		 * frame.
+		 */
+		if (*numEvents + MAX_EVENTS_PER_FINGER + reserved > maxEvents)
+		{
+			t->overflows++;
+			t->active[kept++] = finger;
+			continue;
+		}
+
+		ret = gesture_state_machine_finger(finger,
+		                                   spGeneralSettings->resample ? &target : NULL,
+		                                   events, numEvents);
+
+		//-1 means to move the finger back into the free list
+		if (ret == -1)
+		{
+			finger->state.state = UNUSED;
+			t->free[t->numFree++] = finger;
+		}
+		else
+		{
+			unchanged += ret;
+			t->active[kept++] = finger;
+		}
+	}
+
+	t->numActive = kept;
+	t->unchanged += unchanged;
+
+	if (spGeneralSettings->multiFingerGestures &&
+	        *numEvents + MAX_EVENTS_PER_GESTURE < maxEvents)
+	{
+		multi_finger_gesture_state_machine(pCurTime, events, numEvents);
+	}
+
+	/* a frame of unchanged fingers only is not worth sending */
+	if (*numEvents - first == unchanged)
+	{
+		*numEvents = first;
+	}
+
+	if (0 < *numEvents)
+	{
+		/* add EV_SYN event */
+		set_event_params(&events[(*numEvents)++], pCurTime, EV_SYN, 0, 0);
+	}
+}
+
+/* Number of finger items delta frames left out so far */
+unsigned long gesture_state_machine_unchanged(void)
+{
+	return sFingerTable.unchanged;
+}
+
+/*
+ * Emit the events of one finger. With a resample target the reported position
+ * and timestamp are those of the finger at the target time, except for the
+ * lift off which is reported where it really happened; the gesture state
+ * itself always works on the raw samples.
+ * Returns -1 once the finger is lifted, 1 when delta frames leave it out as
+ * unchanged, with a single FINGER_UNCHANGED event, and 0 otherwise.
+ */
+int gesture_state_machine_finger(finger_t *finger, const time_stamp_t *pTarget,
+                                 input_event_t *events, int *numEvents)
+{
+	int x, y;
+	time_stamp_t timestamp;
+	resampled_coord_t report;
+
+	/* delta frames only carry fingers that went down, moved or went up */
+	if (spGeneralSettings->deltaFrames && finger->present && !finger->changed &&
+	        finger->state.state != START_STATE)
+	{
+		get_last_coords(&finger->coords, &x, &y, &timestamp);
+		set_event_params(&events[(*numEvents)++], &timestamp, EV_FINGERID,
+		                 FINGER_UNCHANGED, FINGER_ID(finger));
+		return 1;
+	}
+
+	finger->changed = false;
+	get_last_coords(&finger->coords, &x, &y, &timestamp);
+
+	if (NULL == pTarget || !finger->present)
+	{
+		/* velocity is still reported, evaluated at the newest sample */
+		pTarget = &timestamp;
+	}
+
+	if (!resample_coord_buffer(&finger->coords, pTarget,
+	                           spGeneralSettings->maxPrediction, &report))
+	{
+		report.xVelocity = 0;
+		report.yVelocity = 0;
+	}
+
+	if (pTarget == &timestamp)
+	{
+		report.x = x;
+		report.y = y;
+		report.timeStamp = timestamp;
+	}
+
+	finger->numEvents = *numEvents;
+	finger->events = events;
+
+	set_event_params(&finger->events[finger->numEvents++], &report.timeStamp,
+	                 EV_FINGERID, 0 , FINGER_ID(finger));
+
+	switch (finger->state.state)
+	{
+		case START_STATE:
+		{
+			finger->state.start[X_DIM] = x;
+			finger->state.start[Y_DIM] = y;
+			finger->state.startTime = timestamp;
+			finger->state.state = FINGER_DOWN_STATE;
+			set_event_params(&finger->events[finger->numEvents++], &report.timeStamp,
+			                 EV_KEY, BTN_TOUCH, 1);
+		}
+		break;
+
+		case FINGER_DOWN_STATE:
+			break;
+
+		case FINGER_DOWN_AFTER_QUICK_LAUNCH:
+		{
+			/* keep reporting pen moves until the finger comes up
+			 * LunaSysMgr will handle the finger until release
+			 */
+		}
+		break;
+
+		case UNUSED:
+			//ASSERT(0);
+			break;
+	}
+
+	set_event_params(&finger->events[finger->numEvents++], &report.timeStamp,
+	                 EV_ABS, ABS_X, report.x);
+	set_event_params(&finger->events[finger->numEvents++], &report.timeStamp,
+	                 EV_ABS, ABS_Y, report.y);
+	set_event_params(&finger->events[finger->numEvents++], &report.timeStamp,
+	                 EV_ABS, ABS_VELOCITY_X, report.xVelocity);
+	set_event_params(&finger->events[finger->numEvents++], &report.timeStamp,
+	                 EV_ABS, ABS_VELOCITY_Y, report.yVelocity);
+	*numEvents = finger->numEvents;
+
+	if (!finger->present)
+	{
+		//send finger release event
+		nyx_debug(MSGID_NYX_MOD_TP_FINGER_UP, 0, "Finger up at %d,%d", x, y);
+		set_event_params(&finger->events[finger->numEvents++], &timestamp, EV_KEY,
+		                 BTN_TOUCH, 0);
+		*numEvents = finger->numEvents;
+		return -1;
+	}
+
+	return 0;
+}
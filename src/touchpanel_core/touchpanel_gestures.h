@@ -0,0 +1,264 @@
+// Copyright (c) 2010-2018 LG Electronics, Inc.
+// Copyright (c) 2012 Simon Busch <morphis@gravedo.de>
+// Copyright (c) 2018 Christophe Chapuis <chris.chapuis@gmail.com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __TOUCHPANEL_GESTURES_H
+#define __TOUCHPANEL_GESTURES_H
+
+#include <limits.h>
+#include <glib.h>
+#include <linux/input.h>
+#include <stdbool.h>
+
+typedef         __u8            uint8_t;
+typedef         __u16           uint16_t;
+typedef         __u32           uint32_t;
+
+
+#define EV_FINGERID 0x07
+
+/*
+ * EV_FINGERID values carry the input device a finger belongs to above the
+ * low 16 bits, so fingers of different panels never share an id. The value
+ * is scaled by 1000 into the nyx item, keep it well within int32_t.
+ */
+#define FINGER_ID_DEVICE_SHIFT  16
+#define FINGER_ID_MASK          ((1u << FINGER_ID_DEVICE_SHIFT) - 1)
+#define FINGER_ID(finger) \
+	(((uint32_t)(finger)->device << FINGER_ID_DEVICE_SHIFT) | (finger)->id)
+
+/*
+ * EV_FINGERID code of a finger that delta frames leave out: it is still down
+ * where it was last reported and no other event follows for it.
+ */
+#define FINGER_UNCHANGED    1
+
+/* private EV_ABS codes carrying the finger velocity, in pixels per second */
+#define ABS_VELOCITY_X  0x3e
+#define ABS_VELOCITY_Y  0x3f
+
+/*
+ * Most events reported for one finger in a frame: EV_FINGERID, BTN_TOUCH
+ * down, ABS_X, ABS_Y, both velocities and BTN_TOUCH up.
+ */
+#define MAX_EVENTS_PER_FINGER   7
+
+/*
+ * Private event type carrying the multi-finger gesture of a frame, after the
+ * finger items and before the EV_SYN; one event per code, GESTURE_STATE
+ * first. See multi_finger_gesture_t for the values.
+ */
+#define EV_GESTURE          0x06
+#define GESTURE_STATE       0
+#define GESTURE_FINGERS     1
+#define GESTURE_CENTER_X    2
+#define GESTURE_CENTER_Y    3
+#define GESTURE_PAN_X       4
+#define GESTURE_PAN_Y       5
+#define GESTURE_SCALE       6
+#define GESTURE_ROTATION    7
+#define MAX_EVENTS_PER_GESTURE  8
+
+typedef struct time_stamp
+{
+	struct timespec time;   /**< internal time stamp format */
+} time_stamp_t;
+
+typedef enum
+{
+	LOCALE_LEFT_RIGHT = 0,
+	LOCALE_RIGHT_LEFT,
+	NUM_LOCALES
+} locale_type_t;
+
+typedef struct interrupt_on_touch_settings
+{
+	bool enabled;
+	int scanRate;           /**< HZ */
+	int wakeThreshold;
+	int noTouchThreshold;   /**< ms */
+	int watchdogTimeout;    /**< ms */
+} interrupt_on_touch_settings_t;
+
+
+typedef struct general_settings
+{
+	int coordBufSize;           /**< length of the coordinate history used for things
+                                     such as avg velocity, 1..COORD_BUF_CAPACITY */
+	int fingerDownThreshold;            /**< threshold to accept finger as down -- access atomically */
+
+	int positionFilter;         /**< smooth positions with the speed dependent filter */
+	double filterMinCutoff;     /**< Hz, cutoff of the filter for a resting finger */
+	double filterBeta;          /**< cutoff increase per pixel per second of speed */
+	double filterDCutoff;       /**< Hz, cutoff applied to the speed estimate */
+
+	bool coalesce;              /**< collapse queued moves of a finger to the latest */
+	bool readerThread;          /**< read and process events on a dedicated thread */
+	bool deltaFrames;           /**< leave unchanged fingers out of frames */
+	bool multiFingerGestures;   /**< report pinch, rotation and pan with the frames */
+	bool resample;              /**< report positions resampled to a target time */
+	int resampleOffset;         /**< us added to the resample target, negative
+                                     values interpolate behind the newest sample */
+	int vsyncPeriod;            /**< us, align the target to the next refresh */
+	int maxPrediction;          /**< us, cap on extrapolation past the newest sample */
+	int maxTouchMajor;          /**< device units, larger contacts are palms, 0 = off */
+	int maxWidthMajor;          /**< device units, larger contacts are palms, 0 = off */
+} general_settings_t;
+
+/*
+ * Coordinate history of a finger. The ring has a fixed power-of-two capacity
+ * and is indexed with a mask; x, y and time are kept in separate arrays
+ * inline in the finger, so a frame only touches the finger table.
+ */
+#define COORD_BUF_CAPACITY  16
+#define COORD_BUF_MASK      (COORD_BUF_CAPACITY - 1)
+
+typedef struct coord_buf
+{
+	int x[COORD_BUF_CAPACITY];
+	int y[COORD_BUF_CAPACITY];
+	time_stamp_t timeStamp[COORD_BUF_CAPACITY];
+	unsigned int tail;      /**< coordinates written so far, masked to index */
+	int numItems;           /**< number of items in the history */
+	int size;               /**< history length, at most COORD_BUF_CAPACITY */
+} coord_buf_t;
+
+/* Ring index of the coordinate age entries before the newest one */
+static inline unsigned int
+coord_buf_index(const coord_buf_t *pCoordBuf, int age)
+{
+	return (pCoordBuf->tail - 1 - age) & COORD_BUF_MASK;
+}
+
+static inline void
+reset_coord_buffer(coord_buf_t *pCoordBuf)
+{
+	pCoordBuf->tail = 0;
+	pCoordBuf->numItems = 0;
+}
+
+static inline void
+update_coord_buffer(coord_buf_t *pCoordBuf, int xCoord, int yCoord,
+                    const time_stamp_t *pTime)
+{
+	unsigned int index = pCoordBuf->tail & COORD_BUF_MASK;
+
+	pCoordBuf->x[index] = xCoord;
+	pCoordBuf->y[index] = yCoord;
+	pCoordBuf->timeStamp[index] = *pTime;
+	pCoordBuf->tail++;
+
+	/* the oldest item drops out of the history once it is full */
+	if (pCoordBuf->numItems < pCoordBuf->size)
+	{
+		pCoordBuf->numItems++;
+	}
+}
+
+static inline void
+get_last_coords(const coord_buf_t *pCoordBuf, int *xCoord, int *yCoord,
+                time_stamp_t *timestamp)
+{
+	unsigned int previndex = coord_buf_index(pCoordBuf, 0);
+
+	if (xCoord)
+	{
+		*xCoord = pCoordBuf->x[previndex];
+	}
+
+	if (yCoord)
+	{
+		*yCoord = pCoordBuf->y[previndex];
+	}
+
+	if (timestamp)
+	{
+		*timestamp = pCoordBuf->timeStamp[previndex];
+	}
+}
+
+/* State of the position filter of a finger, see touchpanel_filter.c */
+typedef struct position_filter
+{
+	double x, y;                /**< filtered position */
+	double dx, dy;              /**< filtered velocity, pixels per second */
+	gint64 lastTime;            /**< ns, time of the previous sample */
+	bool primed;
+} position_filter_t;
+
+typedef enum
+{
+	UNUSED = -1,
+	START_STATE = 0,                        /**< no fingers down */
+	FINGER_DOWN_STATE,                      /**< a finger is down */
+	FINGER_DOWN_AFTER_QUICK_LAUNCH,         /**< a quick launch was detected and we're
+                                               waiting for the finger to come up */
+} gesture_state_t;
+
+#define NUM_DIMENSIONS  2
+#define X_DIM   0
+#define Y_DIM   1
+
+typedef struct gesture_state_data
+{
+	gesture_state_t state;
+	int start[NUM_DIMENSIONS];
+	bool insideTapRadius;
+	time_stamp_t startTime;
+} gesture_state_data_t;
+
+typedef struct
+{
+	struct timeval time;  /**< time event was generated */
+	uint16_t type;        /**< type of event, EV_ABS, EV_MSC, etc. */
+	uint16_t code;        /**< event code, ABS_X, ABS_Y, etc. */
+	int32_t value;        /**< event value: coordinate, intensity,etc. */
+} input_event_t;
+
+typedef struct finger
+{
+	coord_buf_t coords;
+	position_filter_t filter;
+	time_stamp_t timestamp;
+	uint32_t id;
+	int device;                 /**< input device, set by the caller of add_new_finger() */
+	gesture_state_data_t state;
+	bool present;               /**< contact seen in the current frame */
+	bool changed;               /**< went down, moved or lifted since last reported */
+	int lastWeight;
+	int numEvents;
+	input_event_t *events;
+} finger_t;
+
+
+
+void init_gesture_state_machine(const general_settings_t *pGeneralSettings,
+                                int maxFingers);
+void deinit_gesture_state_machine(void);
+void gesture_state_machine(int device, int *pXCoords, int *pYCoords,
+                           const int *pFingerWeights,
+                           int fingerCount, const time_stamp_t *pTime,
+                           input_event_t *events, int maxEvents, int *numEvents);
+finger_t *add_new_finger(int x, int y, int weight, const time_stamp_t *pCurTime);
+void update_finger(finger_t *finger, int x, int y, int weight,
+                   const time_stamp_t *pCurTime);
+void gesture_state_machine_process(const time_stamp_t *pCurTime,
+                                   input_event_t *events, int maxEvents,
+                                   int *numEvents);
+unsigned long gesture_state_machine_unchanged(void);
+
+#endif  /* __TOUCHPANEL_GESTURES_PRV_H */
@@ -0,0 +1,207 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file touchpanel_latency.c
+ *
+ * @brief Touch latency instrumentation
+ *
+ * Every frame added to an event list remembers the kernel timestamp of the
+ * input event that completed it and when it was processed; once
+ * touchpanel_get_event() hands the frame out, the kernel -> SYN processing ->
+ * return latencies go into lock-free histograms.
+ */
+
+#include "touchpanel_latency.h"
+#include "latency_histogram.h"
+
+#include <nyx/module/nyx_log.h>
+#include "msgid.h"
+
+static const char *latency_stage_names[TOUCHPANEL_LATENCY_NUM_STAGES] =
+{
+	"kernel->syn",
+	"syn->return",
+	"kernel->return",
+};
+
+static latency_histogram_t sStages[TOUCHPANEL_LATENCY_NUM_STAGES];
+
+/* clock the kernel stamps input_event.time with */
+static clockid_t sClock = CLOCK_REALTIME;
+
+void
+latency_set_clock(clockid_t clock)
+{
+	sClock = clock;
+}
+
+static int64_t
+latency_clock_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(sClock, &ts);
+	return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void
+latency_queue_reset(latency_queue_t *pQueue)
+{
+	pQueue->head = pQueue->tail = 0;
+}
+
+/* Append a record to the queue, false if it keeps no more records */
+bool
+latency_queue_push(latency_queue_t *pQueue, const frame_latency_t *pFrame)
+{
+	if (pQueue->tail - pQueue->head >= LATENCY_QUEUE_FRAMES)
+	{
+		return false;
+	}
+
+	pQueue->frames[pQueue->tail++ % LATENCY_QUEUE_FRAMES] = *pFrame;
+	return true;
+}
+
+/* Take the oldest record off the queue, false if it is empty */
+bool
+latency_queue_pop(latency_queue_t *pQueue, frame_latency_t *pFrame)
+{
+	if (pQueue->head == pQueue->tail)
+	{
+		return false;
+	}
+
+	*pFrame = pQueue->frames[pQueue->head++ % LATENCY_QUEUE_FRAMES];
+	return true;
+}
+
+/*
+ * Frames dropped by coalescing never get returned; keep the records of the
+ * remaining ones, pFramesKept[i] being the original index of the i-th frame.
+ * Only valid right after a refill, before any frame was returned.
+ */
+void
+latency_queue_keep(latency_queue_t *pQueue, const int *pFramesKept,
+                   int numFrames)
+{
+	int i;
+
+	for (i = 0; i < numFrames && i < LATENCY_QUEUE_FRAMES; i++)
+	{
+		if ((unsigned int)pFramesKept[i] >= pQueue->tail)
+		{
+			break;
+		}
+
+		pQueue->frames[i] = pQueue->frames[pFramesKept[i]];
+	}
+
+	pQueue->head = 0;
+	pQueue->tail = i;
+}
+
+void
+latency_frame_queued(latency_queue_t *pQueue, const struct timeval *pKernelTime)
+{
+	frame_latency_t frame;
+
+	frame.kernelTime = pKernelTime->tv_sec * 1000000000LL +
+	                   pKernelTime->tv_usec * 1000;
+	frame.synTime = latency_clock_now();
+
+	if (latency_queue_push(pQueue, &frame))
+	{
+		latency_histogram_record(&sStages[TOUCHPANEL_LATENCY_KERNEL_TO_SYN],
+		                         frame.synTime - frame.kernelTime);
+	}
+}
+
+void
+latency_frame_returned(latency_queue_t *pQueue)
+{
+	frame_latency_t frame;
+	int64_t now;
+
+	if (!latency_queue_pop(pQueue, &frame))
+	{
+		return;
+	}
+
+	now = latency_clock_now();
+
+	latency_histogram_record(&sStages[TOUCHPANEL_LATENCY_SYN_TO_RETURN],
+	                         now - frame.synTime);
+	latency_histogram_record(&sStages[TOUCHPANEL_LATENCY_KERNEL_TO_RETURN],
+	                         now - frame.kernelTime);
+}
+
+/*
+ * Query the latency of one pipeline stage (touchpanel_latency_stage_t),
+ * all values in nanoseconds. Safe to call from any thread.
+ */
+nyx_error_t
+touchpanel_get_latency(nyx_device_t *d, int stage, uint64_t *p50,
+                       uint64_t *p99, uint64_t *max)
+{
+	const latency_histogram_t *h;
+
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (stage < 0 || stage >= TOUCHPANEL_LATENCY_NUM_STAGES || NULL == p50 ||
+	        NULL == p99 || NULL == max)
+	{
+		return NYX_ERROR_INVALID_VALUE;
+	}
+
+	h = &sStages[stage];
+	*p50 = latency_histogram_percentile(h, 50.0);
+	*p99 = latency_histogram_percentile(h, 99.0);
+	*max = latency_histogram_max(h);
+
+	return NYX_ERROR_NONE;
+}
+
+/* Log p50/p99/max of every stage */
+nyx_error_t
+touchpanel_dump_latency(nyx_device_t *d)
+{
+	int stage;
+
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	for (stage = 0; stage < TOUCHPANEL_LATENCY_NUM_STAGES; stage++)
+	{
+		const latency_histogram_t *h = &sStages[stage];
+
+		nyx_info(MSGID_NYX_MOD_TP_LATENCY, 0,
+		         "%s: %llu frames, p50 %llu us, p99 %llu us, max %llu us",
+		         latency_stage_names[stage],
+		         (unsigned long long) latency_histogram_count(h),
+		         (unsigned long long) latency_histogram_percentile(h, 50.0) / 1000,
+		         (unsigned long long) latency_histogram_percentile(h, 99.0) / 1000,
+		         (unsigned long long) latency_histogram_max(h) / 1000);
+	}
+
+	return NYX_ERROR_NONE;
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __TOUCHPANEL_LATENCY_H
+#define __TOUCHPANEL_LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include <nyx/nyx_module.h>
+#include <nyx-modules/touchpanel.h>
+
+/* when a frame was stamped by the kernel and processed, ns */
+typedef struct frame_latency
+{
+	int64_t kernelTime;
+	int64_t synTime;
+} frame_latency_t;
+
+/* records kept per event list, a frame holds at least an item and its EV_SYN */
+#define LATENCY_QUEUE_FRAMES    128
+
+/* Latency records of the frames in an event list, oldest at head */
+typedef struct latency_queue
+{
+	frame_latency_t frames[LATENCY_QUEUE_FRAMES];
+	unsigned int head;
+	unsigned int tail;
+} latency_queue_t;
+
+void latency_set_clock(clockid_t clock);
+void latency_queue_reset(latency_queue_t *pQueue);
+bool latency_queue_push(latency_queue_t *pQueue, const frame_latency_t *pFrame);
+bool latency_queue_pop(latency_queue_t *pQueue, frame_latency_t *pFrame);
+void latency_queue_keep(latency_queue_t *pQueue, const int *pFramesKept,
+                        int numFrames);
+void latency_frame_queued(latency_queue_t *pQueue,
+                          const struct timeval *pKernelTime);
+void latency_frame_returned(latency_queue_t *pQueue);
+
+#endif  /* __TOUCHPANEL_LATENCY_H */
@@ -0,0 +1,161 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file touchpanel_multifinger.c
+ *
+ * @brief Pinch, rotate and two-finger pan recognition
+ *
+ * While two or more fingers are down their centroid, spread (mean distance
+ * to the centroid) and the angle between the two oldest fingers are tracked
+ * frame to frame. Pan, scale and rotation accumulate the frame to frame
+ * changes, so a finger joining or leaving the gesture moves the reference
+ * instead of making the values jump.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "touchpanel_multifinger.h"
+
+/* below this spread, in pixels, the fingers are too close to tell a pinch */
+#define MIN_SPREAD  1.0
+
+void
+multi_finger_reset(multi_finger_tracker_t *pTracker)
+{
+	memset(pTracker, 0, sizeof(*pTracker));
+}
+
+/**
+ *******************************************************************************
+ * @brief Track the fingers of a new frame
+ *
+ * @param  pTracker     IN/OUT  gesture state
+ * @param  pXCoords     IN      finger positions, oldest finger first
+ * @param  pYCoords     IN
+ * @param  pIds         IN      finger ids
+ * @param  numFingers   IN      fingers down
+ * @param  pGesture     OUT     gesture to report
+ *
+ * @retval true if the gesture began, changed or ended with this frame
+ *******************************************************************************
+ */
+bool
+multi_finger_update(multi_finger_tracker_t *pTracker, const int *pXCoords,
+                    const int *pYCoords, const uint32_t *pIds, int numFingers,
+                    multi_finger_gesture_t *pGesture)
+{
+	double centerX = 0, centerY = 0, spread = 0, angle, delta;
+	multi_finger_state_t state = MULTI_FINGER_UPDATE;
+	uint32_t idSum = 0;
+	int i;
+
+	if (numFingers < 2)
+	{
+		if (!pTracker->active)
+		{
+			return false;
+		}
+
+		pTracker->active = false;
+		*pGesture = pTracker->reported;
+		pGesture->state = MULTI_FINGER_END;
+		pGesture->fingers = numFingers;
+		return true;
+	}
+
+	for (i = 0; i < numFingers; i++)
+	{
+		centerX += pXCoords[i];
+		centerY += pYCoords[i];
+		idSum += pIds[i];
+	}
+
+	centerX /= numFingers;
+	centerY /= numFingers;
+
+	for (i = 0; i < numFingers; i++)
+	{
+		spread += hypot(pXCoords[i] - centerX, pYCoords[i] - centerY);
+	}
+
+	spread /= numFingers;
+	angle = atan2(pYCoords[1] - pYCoords[0], pXCoords[1] - pXCoords[0]);
+
+	if (!pTracker->active)
+	{
+		pTracker->active = true;
+		pTracker->panX = 0;
+		pTracker->panY = 0;
+		pTracker->scale = 1.0;
+		pTracker->rotation = 0;
+		state = MULTI_FINGER_BEGIN;
+	}
+	else if (numFingers == pTracker->numFingers && idSum == pTracker->idSum &&
+	         pIds[0] == pTracker->anchor[0] && pIds[1] == pTracker->anchor[1])
+	{
+		pTracker->panX += centerX - pTracker->centerX;
+		pTracker->panY += centerY - pTracker->centerY;
+
+		if (pTracker->spread >= MIN_SPREAD && spread >= MIN_SPREAD)
+		{
+			pTracker->scale *= spread / pTracker->spread;
+		}
+
+		delta = angle - pTracker->angle;
+
+		if (delta > M_PI)
+		{
+			delta -= 2 * M_PI;
+		}
+		else if (delta <= -M_PI)
+		{
+			delta += 2 * M_PI;
+		}
+
+		pTracker->rotation += delta;
+	}
+
+	pTracker->numFingers = numFingers;
+	pTracker->anchor[0] = pIds[0];
+	pTracker->anchor[1] = pIds[1];
+	pTracker->idSum = idSum;
+	pTracker->centerX = centerX;
+	pTracker->centerY = centerY;
+	pTracker->spread = spread;
+	pTracker->angle = angle;
+
+	pGesture->state = state;
+	pGesture->fingers = numFingers;
+	pGesture->centerX = (int)lround(centerX);
+	pGesture->centerY = (int)lround(centerY);
+	pGesture->panX = (int)lround(pTracker->panX);
+	pGesture->panY = (int)lround(pTracker->panY);
+	pGesture->scale = (int)lround(pTracker->scale * 1000.0);
+	pGesture->rotation = (int)lround(pTracker->rotation * 18000.0 / M_PI);
+
+	/* nothing to report for fingers resting in place */
+	if (state == MULTI_FINGER_UPDATE &&
+	        0 == memcmp(pGesture, &pTracker->reported, sizeof(*pGesture)))
+	{
+		return false;
+	}
+
+	pTracker->reported = *pGesture;
+	pTracker->reported.state = MULTI_FINGER_UPDATE;
+	return true;
+}
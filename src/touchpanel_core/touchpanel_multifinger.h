@@ -0,0 +1,50 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __TOUCHPANEL_MULTIFINGER_H
+#define __TOUCHPANEL_MULTIFINGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nyx-modules/touchpanel.h>
+
+typedef struct multi_finger_tracker
+{
+	bool active;
+	int numFingers;
+	uint32_t anchor[2];         /**< fingers the angle is measured between */
+	uint32_t idSum;             /**< tells when the set of fingers changed */
+
+	/* previous frame */
+	double centerX, centerY;
+	double spread;
+	double angle;
+
+	/* accumulated since the gesture began */
+	double panX, panY;
+	double scale;
+	double rotation;
+
+	multi_finger_gesture_t reported;
+} multi_finger_tracker_t;
+
+void multi_finger_reset(multi_finger_tracker_t *pTracker);
+bool multi_finger_update(multi_finger_tracker_t *pTracker, const int *pXCoords,
+                         const int *pYCoords, const uint32_t *pIds, int numFingers,
+                         multi_finger_gesture_t *pGesture);
+
+#endif  /* __TOUCHPANEL_MULTIFINGER_H */
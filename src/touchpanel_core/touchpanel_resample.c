@@ -0,0 +1,281 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file touchpanel_resample.c
+ *
+ * @brief Resample finger positions to a target time
+ *
+ * The coordinate history of a finger is fitted with x(t) = a + b*t + c*t^2
+ * (least squares, t relative to the newest sample). Positions are linearly
+ * interpolated between samples when the target lies inside the history and
+ * extrapolated along the fitted curve when it lies ahead of the newest
+ * sample, which is what cuts a frame of perceived latency when the target is
+ * the next display refresh. The velocity is the derivative of the fit at the
+ * target time.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "touchpanel_resample.h"
+
+/* samples older than this (relative to the newest) don't take part in the fit */
+#define RESAMPLE_HISTORY_NS     100000000LL
+/* and at most this many of the newest samples */
+#define RESAMPLE_MAX_SAMPLES    16
+
+#define NSEC_PER_SEC            1000000000LL
+#define NSEC_PER_USEC           1000LL
+
+static int64_t sVsyncTime = 0;
+static int64_t sVsyncPeriod = 0;
+
+static inline int64_t
+time_stamp_to_ns(const time_stamp_t *pTime)
+{
+	return (int64_t)pTime->time.tv_sec * NSEC_PER_SEC + pTime->time.tv_nsec;
+}
+
+static inline void
+ns_to_time_stamp(int64_t ns, time_stamp_t *pTime)
+{
+	pTime->time.tv_sec = ns / NSEC_PER_SEC;
+	pTime->time.tv_nsec = ns % NSEC_PER_SEC;
+}
+
+/**
+ * @brief Set the display refresh the resample target is aligned to
+ *
+ * @param  timestamp    IN      time of any past refresh, in ns, same clock as
+ *                              the touch timestamps
+ * @param  period       IN      refresh period in ns, 0 to stop aligning
+ */
+void
+resample_set_vsync(int64_t timestamp, int64_t period)
+{
+	sVsyncTime = timestamp;
+	sVsyncPeriod = period > 0 ? period : 0;
+}
+
+/**
+ * @brief Compute the time the fingers of a frame should be resampled to
+ *
+ * The target is the next display refresh after the frame when a refresh
+ * period is known (from resample_set_vsync() or the vsyncPeriod setting),
+ * otherwise the frame time itself, shifted by resampleOffset.
+ */
+void
+resample_get_target(const general_settings_t *pGeneralSettings,
+                    const time_stamp_t *pFrameTime, time_stamp_t *pTarget)
+{
+	int64_t frame = time_stamp_to_ns(pFrameTime);
+	int64_t period = sVsyncPeriod;
+	int64_t target = frame;
+
+	if (0 == period && pGeneralSettings->vsyncPeriod > 0)
+	{
+		period = pGeneralSettings->vsyncPeriod * NSEC_PER_USEC;
+	}
+
+	if (period > 0)
+	{
+		int64_t phase = (frame - sVsyncTime) % period;
+
+		if (phase < 0)
+		{
+			phase += period;
+		}
+
+		if (phase)
+		{
+			target += period - phase;
+		}
+	}
+
+	target += (int64_t)pGeneralSettings->resampleOffset * NSEC_PER_USEC;
+	ns_to_time_stamp(target, pTarget);
+}
+
+/*
+ * Least squares fit of p(t) = a + b*t + c*t^2, t in ms relative to the newest
+ * sample. Falls back to a line, then to a constant, when the samples don't
+ * span enough distinct times.
+ */
+static void
+fit_quadratic(const double *t, const double *p, int n, double *a, double *b,
+              double *c)
+{
+	double s[5] = { 0 }, sp[3] = { 0 };
+	double det;
+	int i;
+
+	for (i = 0; i < n; i++)
+	{
+		double tt = t[i] * t[i];
+
+		s[0] += 1;
+		s[1] += t[i];
+		s[2] += tt;
+		s[3] += tt * t[i];
+		s[4] += tt * tt;
+		sp[0] += p[i];
+		sp[1] += p[i] * t[i];
+		sp[2] += p[i] * tt;
+	}
+
+	*a = sp[0] / s[0];
+	*b = 0;
+	*c = 0;
+
+	if (n >= 3)
+	{
+		det = s[0] * (s[2] * s[4] - s[3] * s[3])
+		      - s[1] * (s[1] * s[4] - s[3] * s[2])
+		      + s[2] * (s[1] * s[3] - s[2] * s[2]);
+
+		if (fabs(det) > 1e-9)
+		{
+			*a = (sp[0] * (s[2] * s[4] - s[3] * s[3])
+			      - s[1] * (sp[1] * s[4] - s[3] * sp[2])
+			      + s[2] * (sp[1] * s[3] - s[2] * sp[2])) / det;
+			*b = (s[0] * (sp[1] * s[4] - s[3] * sp[2])
+			      - sp[0] * (s[1] * s[4] - s[3] * s[2])
+			      + s[2] * (s[1] * sp[2] - sp[1] * s[2])) / det;
+			*c = (s[0] * (s[2] * sp[2] - sp[1] * s[3])
+			      - s[1] * (s[1] * sp[2] - sp[1] * s[2])
+			      + sp[0] * (s[1] * s[3] - s[2] * s[2])) / det;
+			return;
+		}
+	}
+
+	if (n >= 2)
+	{
+		det = s[0] * s[2] - s[1] * s[1];
+
+		if (fabs(det) > 1e-9)
+		{
+			*a = (sp[0] * s[2] - s[1] * sp[1]) / det;
+			*b = (s[0] * sp[1] - s[1] * sp[0]) / det;
+		}
+	}
+}
+
+/**
+ *******************************************************************************
+ * @brief Resample the position of a finger to the given time
+ *
+ * @param  pCoordBuf        IN      coordinate history of the finger
+ * @param  pTarget          IN      time to resample to
+ * @param  maxPrediction    IN      max extrapolation past the newest sample, us
+ * @param  pResampled       OUT     resampled position and velocity
+ *
+ * @retval  true on success
+ * @retval  false if the history is empty
+ *******************************************************************************
+ */
+bool
+resample_coord_buffer(const coord_buf_t *pCoordBuf, const time_stamp_t *pTarget,
+                      int maxPrediction, resampled_coord_t *pResampled)
+{
+	double t[RESAMPLE_MAX_SAMPLES], px[RESAMPLE_MAX_SAMPLES], py[RESAMPLE_MAX_SAMPLES];
+	double ax, bx, cx, ay, by, cy, dt;
+	int newest, older = -1, newer = -1;
+	int64_t newestTime, target;
+	int i, n = 0;
+
+	if (pCoordBuf->numItems <= 0)
+	{
+		return false;
+	}
+
+	newest = coord_buf_index(pCoordBuf, 0);
+	newestTime = time_stamp_to_ns(&pCoordBuf->timeStamp[newest]);
+	target = time_stamp_to_ns(pTarget);
+
+	/* walk the history from the newest sample back */
+	for (i = 0; i < pCoordBuf->numItems && n < RESAMPLE_MAX_SAMPLES; i++)
+	{
+		int index = coord_buf_index(pCoordBuf, i);
+		int64_t time = time_stamp_to_ns(&pCoordBuf->timeStamp[index]);
+		int64_t age = newestTime - time;
+
+		if (age > RESAMPLE_HISTORY_NS)
+		{
+			break;
+		}
+
+		t[n] = -age / 1e6;
+		px[n] = pCoordBuf->x[index];
+		py[n] = pCoordBuf->y[index];
+		n++;
+
+		if (older < 0 && time <= target)
+		{
+			older = index;
+		}
+
+		if (older < 0)
+		{
+			newer = index;
+		}
+	}
+
+	fit_quadratic(t, px, n, &ax, &bx, &cx);
+	fit_quadratic(t, py, n, &ay, &by, &cy);
+
+	if (target >= newestTime)
+	{
+		/* extrapolate along the fit, anchored at the newest sample */
+		if (target - newestTime > (int64_t)maxPrediction * NSEC_PER_USEC)
+		{
+			target = newestTime + (int64_t)maxPrediction * NSEC_PER_USEC;
+		}
+
+		dt = (target - newestTime) / 1e6;
+		pResampled->x = (int)lround(pCoordBuf->x[newest] + bx * dt + cx * dt * dt);
+		pResampled->y = (int)lround(pCoordBuf->y[newest] + by * dt + cy * dt * dt);
+	}
+	else if (older < 0)
+	{
+		/* target is before the usable history, report its oldest sample */
+		target = time_stamp_to_ns(&pCoordBuf->timeStamp[newer]);
+		dt = (target - newestTime) / 1e6;
+		pResampled->x = pCoordBuf->x[newer];
+		pResampled->y = pCoordBuf->y[newer];
+	}
+	else
+	{
+		/* interpolate between the samples around the target */
+		int64_t t0 = time_stamp_to_ns(&pCoordBuf->timeStamp[older]);
+		int64_t t1 = time_stamp_to_ns(&pCoordBuf->timeStamp[newer]);
+		double alpha = t1 > t0 ? (double)(target - t0) / (double)(t1 - t0) : 1.0;
+
+		dt = (target - newestTime) / 1e6;
+		pResampled->x = (int)lround(pCoordBuf->x[older] +
+		                            (pCoordBuf->x[newer] - pCoordBuf->x[older]) * alpha);
+		pResampled->y = (int)lround(pCoordBuf->y[older] +
+		                            (pCoordBuf->y[newer] - pCoordBuf->y[older]) * alpha);
+	}
+
+	/* d/dt of the fit, from pixels per ms to pixels per second */
+	pResampled->xVelocity = (int)lround((bx + 2 * cx * dt) * 1000.0);
+	pResampled->yVelocity = (int)lround((by + 2 * cy * dt) * 1000.0);
+	ns_to_time_stamp(target, &pResampled->timeStamp);
+
+	return true;
+}
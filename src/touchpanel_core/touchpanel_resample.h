@@ -0,0 +1,40 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __TOUCHPANEL_RESAMPLE_H
+#define __TOUCHPANEL_RESAMPLE_H
+
+#include <stdint.h>
+
+#include "touchpanel_gestures.h"
+
+typedef struct resampled_coord
+{
+	int x;
+	int y;
+	int xVelocity;              /**< pixels per second */
+	int yVelocity;              /**< pixels per second */
+	time_stamp_t timeStamp;     /**< time the position was resampled to */
+} resampled_coord_t;
+
+void resample_set_vsync(int64_t timestamp, int64_t period);
+void resample_get_target(const general_settings_t *pGeneralSettings,
+                         const time_stamp_t *pFrameTime, time_stamp_t *pTarget);
+bool resample_coord_buffer(const coord_buf_t *pCoordBuf,
+                           const time_stamp_t *pTarget, int maxPrediction,
+                           resampled_coord_t *pResampled);
+
+#endif  /* __TOUCHPANEL_RESAMPLE_H */
@@ -0,0 +1,125 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <glib.h>
+#include <stdlib.h>
+
+#ifndef g_assert_true
+#define g_assert_true(X) g_assert((X))
+#endif
+
+//*****************************************************************************
+//*****************************************************************************
+
+// Pull in the unit under test
+#include "../../utils/coord_transform.c"
+
+//*****************************************************************************
+//*****************************************************************************
+
+//
+// Without a calibration the transform matches the former float scaling
+//
+static void test_scaling(void)
+{
+	coord_transform_t t;
+	int x, y, raw;
+
+	g_assert_cmpint(coord_transform_init(&t, 4095, 4095, 1080, 1920, NULL), ==, 0);
+
+	for (raw = 0; raw <= 4095; raw += 5)
+	{
+		coord_transform_apply(&t, raw, raw, &x, &y);
+		g_assert_cmpint(abs(x - (int)(raw * (1080.0f / 4095.0f))), <=, 1);
+		g_assert_cmpint(abs(y - (int)(raw * (1920.0f / 4095.0f))), <=, 1);
+	}
+
+	coord_transform_apply(&t, 4095, 0, &x, &y);
+	g_assert_cmpint(x, ==, 1080);
+	g_assert_cmpint(y, ==, 0);
+}
+
+//
+// A quarter turn maps the device axes onto the swapped display axes
+//
+static void test_rotation(void)
+{
+	static const double rotate90[6] = { 0, -1, 1, 1, 0, 0 };
+	coord_transform_t t;
+	int x, y;
+
+	g_assert_cmpint(coord_transform_init(&t, 1000, 2000, 800, 400, rotate90), ==, 0);
+
+	coord_transform_apply(&t, 0, 0, &x, &y);
+	g_assert_cmpint(x, ==, 800);
+	g_assert_cmpint(y, ==, 0);
+
+	coord_transform_apply(&t, 500, 2000, &x, &y);
+	g_assert_cmpint(x, ==, 0);
+	g_assert_cmpint(y, ==, 200);
+}
+
+//
+// Offsets and scales of a calibration apply in display pixels
+//
+static void test_calibration(void)
+{
+	static const double calibration[6] = { 0.5, 0, 0.25, 0, 2, -0.5 };
+	coord_transform_t t;
+	int x, y;
+
+	g_assert_cmpint(coord_transform_init(&t, 1000, 1000, 1000, 1000, calibration),
+	                ==, 0);
+	coord_transform_apply(&t, 500, 500, &x, &y);
+	g_assert_cmpint(x, ==, 500);
+	g_assert_cmpint(y, ==, 500);
+	coord_transform_apply(&t, 0, 0, &x, &y);
+	g_assert_cmpint(x, ==, 250);
+	g_assert_cmpint(y, ==, -500);
+}
+
+//
+// Empty axes and factors out of range are refused without touching the
+// current transform
+//
+static void test_invalid(void)
+{
+	static const double huge[6] = { 1e12, 0, 0, 0, 1, 0 };
+	coord_transform_t t;
+	int x, y;
+
+	g_assert_cmpint(coord_transform_init(&t, 100, 100, 100, 100, NULL), ==, 0);
+	g_assert_cmpint(coord_transform_init(&t, 0, 100, 100, 100, NULL), ==, -1);
+	g_assert_cmpint(coord_transform_init(&t, 100, 100, 100, 100, huge), ==, -1);
+
+	coord_transform_apply(&t, 42, 7, &x, &y);
+	g_assert_cmpint(x, ==, 42);
+	g_assert_cmpint(y, ==, 7);
+}
+
+//
+// Set-up GLib, then register and run the tests.
+int main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/utils/coord_transform/scaling", test_scaling);
+	g_test_add_func("/utils/coord_transform/rotation", test_rotation);
+	g_test_add_func("/utils/coord_transform/calibration", test_calibration);
+	g_test_add_func("/utils/coord_transform/invalid", test_invalid);
+
+	return g_test_run();
+}
@@ -0,0 +1,145 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <glib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+
+#ifndef g_assert_true
+#define g_assert_true(X) g_assert((X))
+#endif
+
+//*****************************************************************************
+//*****************************************************************************
+
+// Pull in the unit under test
+#include "../../utils/spsc_ring.c"
+
+//*****************************************************************************
+//*****************************************************************************
+
+#define TEST_TRANSFERS      100000
+
+typedef struct
+{
+	uint32_t sequence;
+	uint32_t check;
+} test_slot_t;
+
+//
+// Fill up, then drain in order; the slot count is rounded up to a power of two
+//
+static void test_fill_drain(void)
+{
+	spsc_ring_t ring;
+	test_slot_t *slot;
+	uint32_t i;
+
+	g_assert_cmpint(spsc_ring_init(&ring, sizeof(test_slot_t), 5), ==, 0);
+
+	for (i = 0; i < 8; i++)
+	{
+		slot = spsc_ring_acquire(&ring);
+		g_assert_true(slot != NULL);
+		slot->sequence = i;
+		spsc_ring_publish(&ring);
+	}
+
+	g_assert_true(spsc_ring_acquire(&ring) == NULL);
+	g_assert_cmpuint(spsc_ring_count(&ring), ==, 8);
+
+	for (i = 0; i < 8; i++)
+	{
+		slot = spsc_ring_peek(&ring);
+		g_assert_true(slot != NULL);
+		g_assert_cmpuint(slot->sequence, ==, i);
+		spsc_ring_release(&ring);
+	}
+
+	g_assert_true(spsc_ring_peek(&ring) == NULL);
+	g_assert_cmpuint(spsc_ring_count(&ring), ==, 0);
+
+	spsc_ring_free(&ring);
+}
+
+static void *producer(void *arg)
+{
+	spsc_ring_t *ring = arg;
+	uint32_t i;
+
+	for (i = 0; i < TEST_TRANSFERS; i++)
+	{
+		test_slot_t *slot;
+
+		while (NULL == (slot = spsc_ring_acquire(ring)))
+		{
+			sched_yield();
+		}
+
+		slot->sequence = i;
+		slot->check = ~i;
+		spsc_ring_publish(ring);
+	}
+
+	return NULL;
+}
+
+//
+// A producer thread racing the consumer never loses, reorders or tears slots
+//
+static void test_threaded(void)
+{
+	spsc_ring_t ring;
+	pthread_t thread;
+	uint32_t expected = 0;
+
+	g_assert_cmpint(spsc_ring_init(&ring, sizeof(test_slot_t), 16), ==, 0);
+	g_assert_cmpint(pthread_create(&thread, NULL, producer, &ring), ==, 0);
+
+	while (expected < TEST_TRANSFERS)
+	{
+		test_slot_t *slot = spsc_ring_peek(&ring);
+
+		if (NULL == slot)
+		{
+			sched_yield();
+			continue;
+		}
+
+		g_assert_cmpuint(slot->sequence, ==, expected);
+		g_assert_cmpuint(slot->check, ==, ~expected);
+		spsc_ring_release(&ring);
+		expected++;
+	}
+
+	pthread_join(thread, NULL);
+	g_assert_true(spsc_ring_peek(&ring) == NULL);
+
+	spsc_ring_free(&ring);
+}
+
+//
+// Set-up GLib, then register and run the tests.
+int main(int argc, char **argv)
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/utils/spsc_ring/fill_drain", test_fill_drain);
+	g_test_add_func("/utils/spsc_ring/threaded", test_threaded);
+
+	return g_test_run();
+}
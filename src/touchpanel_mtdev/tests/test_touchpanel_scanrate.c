@@ -0,0 +1,272 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef g_assert_true
+#define g_assert_true(X) g_assert((X))
+#endif
+
+//*****************************************************************************
+//*****************************************************************************
+
+// Pull in the unit under test
+#include "../touchpanel_scanrate.c"
+
+//*****************************************************************************
+//*****************************************************************************
+
+#define TEST_IDLE_TIMEOUT   20      // ms
+
+static char test_path[] = "/tmp/test_touchpanel_scanrateXXXXXX";
+
+static unsigned int attribute_value(void)
+{
+	return read_rate(test_path);
+}
+
+static void set_attribute(unsigned int rate)
+{
+	FILE *f = fopen(test_path, "w");
+
+	g_assert_true(f != NULL);
+	fprintf(f, "%u\n", rate);
+	fclose(f);
+}
+
+static void wait_ms(int ms)
+{
+	usleep(ms * 1000);
+}
+
+//
+// Counters are updated by the idle thread, read them under its lock
+//
+static unsigned long idle_entries(scan_rate_t *sr)
+{
+	unsigned long n;
+
+	pthread_mutex_lock(&sr->lock);
+	n = sr->idleEntries;
+	pthread_mutex_unlock(&sr->lock);
+
+	return n;
+}
+
+static bool is_idle(scan_rate_t *sr)
+{
+	bool idle;
+
+	pthread_mutex_lock(&sr->lock);
+	idle = sr->idle;
+	pthread_mutex_unlock(&sr->lock);
+
+	return idle;
+}
+
+//
+// The idle thread restores the active rate, give it a moment
+//
+static unsigned int wait_for_rate(unsigned int rate)
+{
+	int i;
+
+	for (i = 0; i < 100 && attribute_value() != rate; i++)
+	{
+		wait_ms(1);
+	}
+
+	return attribute_value();
+}
+
+static void init_scan_rate(scan_rate_t *sr, unsigned int active)
+{
+	interrupt_on_touch_settings_t idle =
+	{
+		.enabled = true,
+		.scanRate = 10,
+		.noTouchThreshold = TEST_IDLE_TIMEOUT,
+	};
+
+	g_assert_cmpint(scan_rate_init(sr, test_path, active, &idle), ==, 0);
+}
+
+//
+// Idle after the timeout without contacts, active again on the first touch
+//
+static void test_idle_and_wake(void)
+{
+	scan_rate_t sr;
+
+	set_attribute(0);
+	init_scan_rate(&sr, 120);
+	g_assert_cmpuint(attribute_value(), ==, 120);
+
+	wait_ms(TEST_IDLE_TIMEOUT * 4);
+	g_assert_cmpuint(attribute_value(), ==, 10);
+	g_assert_true(is_idle(&sr));
+
+	scan_rate_contacts(&sr, 1);
+	g_assert_cmpuint(wait_for_rate(120), ==, 120);
+
+	// no idling while touched
+	wait_ms(TEST_IDLE_TIMEOUT * 4);
+	g_assert_cmpuint(attribute_value(), ==, 120);
+
+	scan_rate_contacts(&sr, 0);
+	wait_ms(TEST_IDLE_TIMEOUT * 4);
+	g_assert_cmpuint(attribute_value(), ==, 10);
+	g_assert_cmpuint(idle_entries(&sr), ==, 2);
+
+	// back to the active rate on close
+	scan_rate_deinit(&sr);
+	g_assert_cmpuint(attribute_value(), ==, 120);
+}
+
+//
+// A contact within the timeout keeps the controller active
+//
+static void test_short_release(void)
+{
+	scan_rate_t sr;
+
+	set_attribute(0);
+	init_scan_rate(&sr, 120);
+	scan_rate_contacts(&sr, 2);
+	scan_rate_contacts(&sr, 0);
+	wait_ms(TEST_IDLE_TIMEOUT / 4);
+	scan_rate_contacts(&sr, 1);
+	wait_ms(TEST_IDLE_TIMEOUT * 4);
+
+	g_assert_cmpuint(attribute_value(), ==, 120);
+	g_assert_cmpuint(idle_entries(&sr), ==, 0);
+
+	scan_rate_deinit(&sr);
+}
+
+//
+// Without a configured active rate the current one is kept and restored
+//
+static void test_current_rate_kept(void)
+{
+	scan_rate_t sr;
+
+	set_attribute(90);
+	init_scan_rate(&sr, 0);
+	g_assert_cmpuint(sr.activeRate, ==, 90);
+
+	wait_ms(TEST_IDLE_TIMEOUT * 4);
+	g_assert_cmpuint(attribute_value(), ==, 10);
+
+	scan_rate_contacts(&sr, 1);
+	g_assert_cmpuint(wait_for_rate(90), ==, 90);
+
+	g_assert_cmpint(scan_rate_set_active(&sr, 60), ==, 0);
+	g_assert_cmpuint(attribute_value(), ==, 60);
+
+	scan_rate_deinit(&sr);
+}
+
+//
+// Without an active rate to come back to, the controller never goes idle
+//
+static void test_unknown_active_rate(void)
+{
+	scan_rate_t sr;
+	interrupt_on_touch_settings_t idle =
+	{
+		.enabled = true,
+		.scanRate = 10,
+		.noTouchThreshold = TEST_IDLE_TIMEOUT,
+	};
+
+	set_attribute(0);
+	g_assert_cmpint(scan_rate_init(&sr, test_path, 0, &idle), <, 0);
+	g_assert_true(sr.path == NULL);
+
+	wait_ms(TEST_IDLE_TIMEOUT * 4);
+	g_assert_cmpuint(attribute_value(), ==, 0);
+	scan_rate_contacts(&sr, 1);
+	scan_rate_deinit(&sr);
+}
+
+//
+// A tap lifted before the idle thread ran still wakes the controller
+//
+static void test_short_tap_wakes(void)
+{
+	scan_rate_t sr;
+
+	set_attribute(0);
+	init_scan_rate(&sr, 120);
+	wait_ms(TEST_IDLE_TIMEOUT * 4);
+	g_assert_cmpuint(attribute_value(), ==, 10);
+
+	scan_rate_contacts(&sr, 1);
+	scan_rate_contacts(&sr, 0);
+	g_assert_cmpuint(wait_for_rate(120), ==, 120);
+
+	wait_ms(TEST_IDLE_TIMEOUT * 4);
+	g_assert_cmpuint(attribute_value(), ==, 10);
+	g_assert_cmpuint(idle_entries(&sr), ==, 2);
+
+	scan_rate_deinit(&sr);
+}
+
+//
+// No path, no control
+//
+static void test_disabled(void)
+{
+	scan_rate_t sr;
+	interrupt_on_touch_settings_t idle = { .enabled = false };
+
+	g_assert_cmpint(scan_rate_init(&sr, NULL, 120, &idle), ==, 0);
+	g_assert_true(sr.path == NULL);
+	scan_rate_contacts(&sr, 1);
+	scan_rate_deinit(&sr);
+}
+
+//
+// Set-up GLib, then register and run the tests.
+int main(int argc, char **argv)
+{
+	int fd, ret;
+
+	g_test_init(&argc, &argv, NULL);
+
+	fd = mkstemp(test_path);
+	g_assert_true(fd >= 0);
+	close(fd);
+
+	g_test_add_func("/touchpanel/scanrate/idle_and_wake", test_idle_and_wake);
+	g_test_add_func("/touchpanel/scanrate/short_release", test_short_release);
+	g_test_add_func("/touchpanel/scanrate/current_rate_kept",
+	                test_current_rate_kept);
+	g_test_add_func("/touchpanel/scanrate/unknown_active_rate",
+	                test_unknown_active_rate);
+	g_test_add_func("/touchpanel/scanrate/short_tap_wakes", test_short_tap_wakes);
+	g_test_add_func("/touchpanel/scanrate/disabled", test_disabled);
+
+	ret = g_test_run();
+	unlink(test_path);
+
+	return ret;
+}
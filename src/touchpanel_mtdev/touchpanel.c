@@ -33,14 +33,19 @@
 #include <glib.h>
 #include <errno.h>
 #include <poll.h>
+#include <pthread.h>
 #include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
 
 #include <mtdev.h>
+#include <mtdev-plumbing.h>
 
 #include <nyx/nyx_module.h>
 #include <nyx/module/nyx_event_touchpanel_internal.h>
 #include <nyx/common/nyx_macros.h>
 #include <nyx/module/nyx_utils.h>
+#include <nyx-modules/touchpanel.h>
 
 
 #include <sys/socket.h>
@@ -50,6 +55,15 @@
 #include <fcntl.h>
 
 #include "touchpanel_gestures.h"
+#include "touchpanel_common.h"
+#include "touchpanel_resample.h"
+#include "touchpanel_coalesce.h"
+#include "touchpanel_multifinger.h"
+#include "touchpanel_scanrate.h"
+#include "touchpanel_latency.h"
+#include "spsc_ring.h"
+#include "coord_transform.h"
+#include "evdev_mask.h"
 #include "msgid.h"
 
 /* Later versions of nyx_utils.h no longer define this macro */
@@ -61,48 +75,287 @@
     }                                                         \
   } while(0)
 
+/*
+ * Number of preallocated touch events. Consumers usually hold on to one or
+ * two frames before releasing them; pool misses fall back to the heap and are
+ * counted in touch_event_pool_t.exhausted so the pool can be sized.
+ */
+#define TOUCH_EVENT_POOL_SIZE   16
+
+typedef struct touch_event_pool_entry
+{
+	nyx_event_touchpanel_t event;   /**< must stay first, handed out to nyx */
+	struct touch_event_pool_entry *next;
+	bool unchanged[NYX_MAX_TOUCH_EVENTS];   /**< items left out of a delta frame */
+	multi_finger_gesture_t gesture; /**< state MULTI_FINGER_NONE without one */
+} touch_event_pool_entry_t;
+
+typedef struct
+{
+	touch_event_pool_entry_t entries[TOUCH_EVENT_POOL_SIZE];
+	touch_event_pool_entry_t *free_list;
+	unsigned long exhausted;        /**< acquires that had to use the heap */
+} touch_event_pool_t;
+
 typedef struct
 {
 	nyx_device_t _parent;
 	nyx_event_touchpanel_t *current_event_ptr;
 	int32_t mode;
+	touch_event_pool_t event_pool;
 } touchpanel_device_t;
 
 NYX_DECLARE_MODULE(NYX_DEVICE_TOUCHPANEL, "Touchpanel");
 
+/* minimum capacity of the event list, it grows with the slot count */
 #define MAX_HIDD_EVENTS     (4096 / sizeof(input_event_t))
 
 typedef struct
 {
 	size_t input_filled;
 	size_t input_read;
-	input_event_t input[MAX_HIDD_EVENTS];
+	size_t capacity;            /**< number of entries in input */
+	input_event_t *input;
+	coalesce_scratch_t coalesce;
+	latency_queue_t latency;    /**< records of the frames in input */
 } event_list_t;
 
+/*
+ * Multitouch slot state, one entry per slot the device reports. The arrays
+ * are carved out of a single allocation made at open time.
+ */
 typedef struct
 {
-	int touchMajor;
-	int touchMinor;
-	int widthMajor;
-	int widthMinor;
-	int orientation;
-	int posX;
-	int posY;
-	int tracking_id;
-	int previous_tracking_id;
-	struct finger_t *nyx_finger;
-} mt_slot_t;
-struct mtdev *ts_mtdev = NULL;
+	int count;
+	int *rawX;                  /**< device coordinates */
+	int *rawY;
+	int *posX;                  /**< display coordinates */
+	int *posY;
+	int *tracking_id;
+	int *previous_tracking_id;
+	int *touchMajor;
+	int *touchMinor;
+	int *widthMajor;
+	int *widthMinor;
+	int *orientation;
+	int *rejected;              /**< contact rejected as a palm until lifted */
+	int *dirty;                 /**< raw position changed since the last frame */
+	finger_t **nyx_finger;
+} mt_slots_t;
+/*
+ * Number of slots used when the device does not report ABS_MT_SLOT (type A
+ * devices, mtdev tracks their contacts itself), and upper bound for devices
+ * reporting a bogus range: mtdev itself tracks no more than 32 contacts
+ * (DIM_FINGER, not exported).
+ */
+#define DEFAULT_MT_SLOTS    10
+#define MAX_MT_SLOTS        32
+
+/*
+ * Pending kernel events are pulled from the device node with a single read()
+ * per drain instead of one syscall per input_event.
+ */
+#define MAX_RAW_EVENTS      (4096 / sizeof(input_event_t))
+
 /*
- * Maximum number of slots that this driver can handle for multitouch.
- * Since we have 10 fingers, it seems sensible to have a max of 10 slots.
+ * One touch input device. Each panel keeps its own mtdev, slots, coordinate
+ * transform and drop recovery state; the fingers of all of them share the
+ * gesture state machine, their ids namespaced with the device index.
  */
-#define MAX_MT_SLOTS    10
-mt_slot_t *mt_slots = NULL;
+typedef struct touch_input
+{
+	int index;
+	int fd;
+	struct mtdev *mtdev;        /**< NULL for single-touch devices */
+	mt_slots_t slots;
+	int currentSlot;
+	int contacts;               /**< contacts down after the last frame */
+	coord_transform_t transform;
+	int cachedX, cachedY;       /**< single-touch raw position */
+	int cachedButtonState;
+	bool syncDropped;
+	input_event_t raw[MAX_RAW_EVENTS];  /**< read from the kernel, mtdev only */
+	int rawNext;                /**< first raw event not fed to mtdev yet */
+	int rawCount;
+} touch_input_t;
+
+/* the device index has to fit the finger ids, see FINGER_ID_DEVICE_SHIFT */
+#define MAX_TOUCH_INPUTS    8
+
+static touch_input_t sInputs[MAX_TOUCH_INPUTS];
+static int sNumInputs = 0;
+static int sEpollFd = -1;    /**< all touch devices, the event source */
 
 
 event_list_t touchpanel_event_list;
-int touchpanel_event_fd = -1;
+
+typedef struct
+{
+	unsigned long syscalls;     /**< read() calls issued on the event device */
+	unsigned long events;       /**< raw input events read from the kernel */
+	unsigned long frames;       /**< SYN_REPORT frames processed */
+	unsigned long drops;        /**< SYN_DROPPED reported by the kernel */
+	unsigned long discarded;    /**< incomplete events thrown away after a drop */
+	unsigned long resyncs;      /**< device state re-read after a drop */
+	unsigned long coalesced;    /**< moves merged into a later one */
+	unsigned long palms;        /**< contacts rejected as palms */
+} touchpanel_read_stats_t;
+
+static touchpanel_read_stats_t sReadStats;
+
+/*
+ * Optional reader thread. It owns the device, mtdev and the gesture state
+ * machine: it blocks on the event device, runs the pipeline into
+ * touchpanel_event_list and copies every finished frame into a lock-free
+ * ring. The consumer only pulls frames out of the ring into its own list from
+ * touchpanel_get_event(), woken up through an eventfd, so a stalled consumer
+ * no longer leaves the kernel buffer to overflow.
+ */
+#define READER_RING_FRAMES      256
+/* ms the reader sleeps while the ring is full */
+#define READER_STALL_WAIT_MS    4
+
+typedef struct
+{
+	frame_latency_t latency;
+	bool hasLatency;
+	int numEvents;
+	input_event_t events[];
+} reader_frame_t;
+
+typedef struct
+{
+	bool running;
+	pthread_t thread;
+	int readyFd;                /**< eventfd handed out as event source */
+	int stopFd;                 /**< eventfd asking the thread to exit */
+	spsc_ring_t ring;
+	event_list_t output;        /**< frames taken out of the ring, consumer side */
+	unsigned long stalls;       /**< times the reader waited for the consumer */
+} touchpanel_reader_t;
+
+static touchpanel_reader_t sReader =
+{
+	.readyFd = -1,
+	.stopFd = -1,
+};
+
+/*
+ * Worst case number of events a single SYN_REPORT frame can add to the event
+ * list: a contact replaced within the frame releases one finger and adds
+ * another, so the finger table holds up to two fingers per slot, plus the
+ * multi-finger gesture and the trailing EV_SYN.
+ */
+static size_t sEventsPerFrame = DEFAULT_MT_SLOTS * 2 * MAX_EVENTS_PER_FINGER +
+                                MAX_EVENTS_PER_GESTURE + 1;
+
+static int
+init_mt_slots(mt_slots_t *slots, int count)
+{
+	char *block;
+	int iSlot;
+
+	block = calloc(count, 13 * sizeof(int) + sizeof(finger_t *));
+
+	if (NULL == block)
+	{
+		return -1;
+	}
+
+	/* the pointer array goes first to keep it aligned */
+	slots->nyx_finger = (finger_t **)block;
+	slots->rawX = (int *)(block + count * sizeof(finger_t *));
+	slots->rawY = slots->rawX + count;
+	slots->posX = slots->rawY + count;
+	slots->posY = slots->posX + count;
+	slots->tracking_id = slots->posY + count;
+	slots->previous_tracking_id = slots->tracking_id + count;
+	slots->touchMajor = slots->previous_tracking_id + count;
+	slots->touchMinor = slots->touchMajor + count;
+	slots->widthMajor = slots->touchMinor + count;
+	slots->widthMinor = slots->widthMajor + count;
+	slots->orientation = slots->widthMinor + count;
+	slots->rejected = slots->orientation + count;
+	slots->dirty = slots->rejected + count;
+	slots->count = count;
+
+	for (iSlot = 0; iSlot < count; iSlot++)
+	{
+		slots->tracking_id[iSlot] = -1;
+		slots->previous_tracking_id[iSlot] = -1;
+		/* display positions are derived at the first frame */
+		slots->dirty[iSlot] = 1;
+	}
+
+	return 0;
+}
+
+static void
+free_mt_slots(mt_slots_t *slots)
+{
+	free(slots->nyx_finger);
+	memset(slots, 0, sizeof(*slots));
+}
+
+static void
+release_event_list(event_list_t *list)
+{
+	free(list->input);
+	free(list->coalesce.fingers);
+	memset(list, 0, sizeof(*list));
+}
+
+static int
+alloc_event_list(event_list_t *list, size_t capacity, int numSlots)
+{
+	memset(list, 0, sizeof(*list));
+
+	list->input = calloc(capacity, sizeof(input_event_t));
+	list->coalesce.fingers = calloc(numSlots * 4, sizeof(uint32_t));
+	list->coalesce.maxFingers = numSlots * 4;
+
+	if (NULL == list->input || NULL == list->coalesce.fingers)
+	{
+		release_event_list(list);
+		return -1;
+	}
+
+	list->capacity = capacity;
+
+	return 0;
+}
+
+static void
+free_event_list(void)
+{
+	release_event_list(&touchpanel_event_list);
+}
+
+/* room for a few frames per drain */
+static size_t
+event_list_capacity(void)
+{
+	size_t capacity = 4 * sEventsPerFrame;
+
+	return capacity < MAX_HIDD_EVENTS ? MAX_HIDD_EVENTS : capacity;
+}
+
+static int
+init_event_list(int numSlots)
+{
+	sEventsPerFrame = numSlots * 2 * MAX_EVENTS_PER_FINGER +
+	                  MAX_EVENTS_PER_GESTURE + 1;
+
+	return alloc_event_list(&touchpanel_event_list, event_list_capacity(),
+	                        numSlots);
+}
+
+static size_t
+event_list_room(void)
+{
+	return touchpanel_event_list.capacity - touchpanel_event_list.input_filled /
+	       sizeof(input_event_t);
+}
 
 static void touch_item_reset(nyx_touchpanel_event_item_t *t)
 {
@@ -116,20 +369,55 @@ static void touch_item_reset(nyx_touchpanel_event_item_t *t)
 	t->weight = (double) NAN;
 }
 
-static nyx_event_touchpanel_t *touch_event_create()
+static void touch_event_pool_init(touch_event_pool_t *pool)
+{
+	int i;
+
+	pool->free_list = NULL;
+	pool->exhausted = 0;
+
+	for (i = TOUCH_EVENT_POOL_SIZE - 1; i >= 0; i--)
+	{
+		pool->entries[i].next = pool->free_list;
+		pool->free_list = &pool->entries[i];
+	}
+}
+
+static bool touch_event_pool_owns(const touch_event_pool_t *pool,
+                                  const nyx_event_touchpanel_t *event_ptr)
+{
+	return (const void *) event_ptr >= (const void *) &pool->entries[0] &&
+	       (const void *) event_ptr < (const void *) &pool->entries[TOUCH_EVENT_POOL_SIZE];
+}
+
+static nyx_event_touchpanel_t *touch_event_create(touchpanel_device_t *d)
 {
-	nyx_event_touchpanel_t *event_ptr;
-	event_ptr =
-	    (nyx_event_touchpanel_t *) calloc(sizeof(nyx_event_touchpanel_t), 1);
+	touch_event_pool_entry_t *entry;
+	touch_event_pool_t *pool = &d->event_pool;
 
-	if (NULL == event_ptr)
+	if (G_LIKELY(pool->free_list))
+	{
+		entry = pool->free_list;
+		pool->free_list = entry->next;
+	}
+	else
 	{
-		return event_ptr;
+		/* heap events carry the same metadata as pooled ones */
+		pool->exhausted++;
+		entry =
+		    (touch_event_pool_entry_t *) calloc(sizeof(touch_event_pool_entry_t), 1);
+
+		if (NULL == entry)
+		{
+			return NULL;
+		}
 	}
 
-	event_ptr->type = NYX_TOUCHPANEL_EVENT_TYPE_TOUCH;
-	event_ptr->item_count = 0;
-	return event_ptr;
+	memset(entry->unchanged, 0, sizeof(entry->unchanged));
+	memset(&entry->gesture, 0, sizeof(entry->gesture));
+	entry->event.type = NYX_TOUCHPANEL_EVENT_TYPE_TOUCH;
+	entry->event.item_count = 0;
+	return &entry->event;
 }
 
 nyx_error_t touchpanel_release_event(nyx_device_t *d, nyx_event_t *e)
@@ -144,8 +432,20 @@ nyx_error_t touchpanel_release_event(nyx_device_t *d, nyx_event_t *e)
 		return NYX_ERROR_INVALID_HANDLE;
 	}
 
+	touch_event_pool_t *pool = &((touchpanel_device_t *) d)->event_pool;
 	nyx_event_touchpanel_t *a = (nyx_event_touchpanel_t *) e;
-	free(a);
+
+	if (touch_event_pool_owns(pool, a))
+	{
+		touch_event_pool_entry_t *entry = (touch_event_pool_entry_t *) a;
+		entry->next = pool->free_list;
+		pool->free_list = entry;
+	}
+	else
+	{
+		free(a);
+	}
+
 	return NYX_ERROR_NONE;
 }
 
@@ -191,6 +491,9 @@ static inline int64_t get_ts_tval(struct timeval *tv)
 	return tv->tv_sec * 1000000000LL + tv->tv_usec * 1000;
 }
 
+/* clock the kernel stamps input_event.time with, see init_event_clock() */
+static clockid_t sEventClock = CLOCK_REALTIME;
+
 #define VBOXGUEST_DEVICE_NAME   "/dev/vboxguest"
 
 /** Version of VMMDevRequestHeader structure. */
@@ -343,9 +646,225 @@ error:
 static general_settings_t sGeneralSettings =
 {
 	.coordBufSize = 6,
-	.fingerDownThreshold = 0
+	.fingerDownThreshold = 0,
+	.positionFilter = 0,
+	.filterMinCutoff = 1.0,
+	.filterBeta = 0.1,
+	.filterDCutoff = 1.0,
+	.coalesce = false,
+	.readerThread = false,
+	.deltaFrames = false,
+	.multiFingerGestures = false,
+	.resample = false,
+	.resampleOffset = 0,
+	.vsyncPeriod = 0,
+	.maxPrediction = 8000,
+	.maxTouchMajor = 0,
+	.maxWidthMajor = 0
+};
+
+/*
+ * Settings changed through the nyx methods. The input path runs on the
+ * reader thread when there is one, so changes wait here until it picks them
+ * up before its next read; a frame never sees half of an update. coalesce is
+ * only used by the consumer and changed directly.
+ */
+#define SETTINGS_DELTA_FRAMES   (1 << 0)
+#define SETTINGS_MULTI_FINGER   (1 << 1)
+#define SETTINGS_VSYNC          (1 << 2)
+
+typedef struct
+{
+	pthread_mutex_t lock;
+	unsigned int changed;       /**< SETTINGS_* waiting to be picked up */
+	bool deltaFrames;
+	bool multiFingerGestures;
+	int64_t vsyncTime;
+	int64_t vsyncPeriod;
+} settings_update_t;
+
+static settings_update_t sSettingsUpdate =
+{
+	.lock = PTHREAD_MUTEX_INITIALIZER,
 };
 
+/* idle scan rate and timeout, active when a scanRatePath is configured */
+static interrupt_on_touch_settings_t sIdleSettings =
+{
+	.enabled = false,
+	.scanRate = 0,
+	.noTouchThreshold = 5000,
+};
+
+static int sActiveScanRate = 0;
+static gchar *sScanRatePath = NULL;
+static scan_rate_t sScanRate;
+
+/* normalized calibration applied on top of each device's scaling */
+static double sCalibration[6] = { 1, 0, 0, 0, 1, 0 };
+
+#ifdef TOUCHPANEL_DEVICE
+#define DEFAULT_TOUCHPANEL_DEVICE   TOUCHPANEL_DEVICE
+#else
+#define DEFAULT_TOUCHPANEL_DEVICE   "/dev/input/touchscreen0"
+#endif
+
+/* event devices of all the touch panels, NULL terminated */
+static gchar **sInputPaths = NULL;
+
+static void
+load_conf_int(GKeyFile *keyfile, const gchar *key, int *value)
+{
+	GError *error = NULL;
+	gint result = g_key_file_get_integer(keyfile, NYX_CONF_GROUP_TOUCHPANEL, key,
+	                                     &error);
+
+	if (error)
+	{
+		g_error_free(error);
+		return;
+	}
+
+	*value = result;
+}
+
+static void
+load_conf_double(GKeyFile *keyfile, const gchar *key, double *value)
+{
+	GError *error = NULL;
+	gdouble result = g_key_file_get_double(keyfile, NYX_CONF_GROUP_TOUCHPANEL, key,
+	                                       &error);
+
+	if (error)
+	{
+		g_error_free(error);
+		return;
+	}
+
+	*value = result;
+}
+
+static void
+load_conf_bool(GKeyFile *keyfile, const gchar *key, bool *value)
+{
+	GError *error = NULL;
+	gboolean result = g_key_file_get_boolean(keyfile, NYX_CONF_GROUP_TOUCHPANEL,
+	                                         key, &error);
+
+	if (error)
+	{
+		g_error_free(error);
+		return;
+	}
+
+	*value = result;
+}
+
+/*
+ * Optional overrides of the general settings from the module.touchpanel group
+ * of the nyx configuration file, e.g.
+ *
+ *   [module.touchpanel]
+ *   readerThread=true
+ *   coalesce=true
+ *   deltaFrames=true
+ *   multiFingerGestures=true
+ *   positionFilter=1
+ *   filterMinCutoff=1.0
+ *   filterBeta=0.1
+ *   filterDCutoff=1.0
+ *   resample=true
+ *   vsyncPeriod=16667
+ *   resampleOffset=0
+ *   maxPrediction=8000
+ *   maxTouchMajor=40
+ *   maxWidthMajor=60
+ *   scanRatePath=/sys/devices/.../scan_rate
+ *   activeScanRate=120
+ *   idleScanRate=10
+ *   idleTimeout=5000
+ *   calibrationMatrix=0;-1;1;1;0;0
+ *   paths=/dev/input/touchscreen0;/dev/input/pen0
+ *
+ * See load_calibration() for the calibration matrix, the example rotates
+ * the panel by 90 degrees. Without paths the module serves the single panel
+ * at DEFAULT_TOUCHPANEL_DEVICE. The filter* keys tune the positionFilter, see
+ * touchpanel_filter.c.
+ */
+static void
+load_touchpanel_settings(general_settings_t *pSettings)
+{
+	GError *error = NULL;
+	GKeyFile *keyfile = g_key_file_new();
+
+	g_strfreev(sInputPaths);
+	sInputPaths = NULL;
+	g_key_file_set_list_separator(keyfile, ';');
+
+	if (!g_key_file_load_from_file(keyfile, NYX_CONF_FILE, G_KEY_FILE_NONE, &error))
+	{
+		nyx_debug("[touchpanel] no settings loaded from %s", NYX_CONF_FILE);
+		g_error_free(error);
+		goto cleanup;
+	}
+
+	sInputPaths = g_key_file_get_string_list(keyfile, NYX_CONF_GROUP_TOUCHPANEL,
+	                                         "paths", NULL, NULL);
+
+	load_conf_bool(keyfile, "resample", &pSettings->resample);
+	load_conf_bool(keyfile, "coalesce", &pSettings->coalesce);
+	load_conf_bool(keyfile, "readerThread", &pSettings->readerThread);
+	load_conf_bool(keyfile, "deltaFrames", &pSettings->deltaFrames);
+	load_conf_bool(keyfile, "multiFingerGestures", &pSettings->multiFingerGestures);
+
+	load_conf_int(keyfile, "coordBufSize", &pSettings->coordBufSize);
+	load_conf_int(keyfile, "positionFilter", &pSettings->positionFilter);
+	load_conf_double(keyfile, "filterMinCutoff", &pSettings->filterMinCutoff);
+	load_conf_double(keyfile, "filterBeta", &pSettings->filterBeta);
+	load_conf_double(keyfile, "filterDCutoff", &pSettings->filterDCutoff);
+	load_conf_int(keyfile, "resampleOffset", &pSettings->resampleOffset);
+	load_conf_int(keyfile, "vsyncPeriod", &pSettings->vsyncPeriod);
+	load_conf_int(keyfile, "maxPrediction", &pSettings->maxPrediction);
+	load_conf_int(keyfile, "maxTouchMajor", &pSettings->maxTouchMajor);
+	load_conf_int(keyfile, "maxWidthMajor", &pSettings->maxWidthMajor);
+
+	g_free(sScanRatePath);
+	sScanRatePath = g_key_file_get_string(keyfile, NYX_CONF_GROUP_TOUCHPANEL,
+	                                      "scanRatePath", NULL);
+	sIdleSettings.enabled = sScanRatePath != NULL;
+	load_conf_int(keyfile, "activeScanRate", &sActiveScanRate);
+	load_conf_int(keyfile, "idleScanRate", &sIdleSettings.scanRate);
+	load_conf_int(keyfile, "idleTimeout", &sIdleSettings.noTouchThreshold);
+	load_calibration(keyfile, sCalibration);
+
+	if (pSettings->coordBufSize < 1)
+	{
+		pSettings->coordBufSize = 1;
+	}
+	else if (pSettings->coordBufSize > COORD_BUF_CAPACITY)
+	{
+		nyx_debug("[touchpanel] coordBufSize limited to %d", COORD_BUF_CAPACITY);
+		pSettings->coordBufSize = COORD_BUF_CAPACITY;
+	}
+
+	if (!(pSettings->filterMinCutoff > 0) || !(pSettings->filterDCutoff > 0) ||
+	        !(pSettings->filterBeta >= 0))
+	{
+		nyx_debug("[touchpanel] invalid position filter parameters, filter off");
+		pSettings->positionFilter = 0;
+	}
+
+cleanup:
+	g_key_file_free(keyfile);
+
+	if (NULL == sInputPaths || NULL == sInputPaths[0])
+	{
+		g_strfreev(sInputPaths);
+		sInputPaths = g_new0(gchar *, 2);
+		sInputPaths[0] = g_strdup(DEFAULT_TOUCHPANEL_DEVICE);
+	}
+}
+
 #define FRAMEBUF_DEVICE_NAME    "/dev/fb"
 
 static int
@@ -379,100 +898,422 @@ exit:
 }
 
 
-static float scaleX, scaleY;
+static int start_reader_thread(int numSlots);
+static void stop_reader_thread(void);
+static void handle_new_mt_event(touch_input_t *input, input_event_t *event);
+static void handle_new_event(touch_input_t *input, input_event_t *event);
 
-static int
-init_touchpanel(void)
+/*
+ * Have the kernel stamp events with CLOCK_MONOTONIC so wall clock changes do
+ * not end up in the gesture math or in the timestamps handed upstream. The
+ * fingers of all inputs share the gesture state and the latency math, so
+ * either every input switches or all of them stay on CLOCK_REALTIME.
+ */
+static void
+init_event_clock(void)
 {
-	struct input_absinfo abs;
-	int  maxX, maxY, sXres, sYres, ret = -1;
-
-#ifdef TOUCHPANEL_DEVICE
-	touchpanel_event_fd = open(TOUCHPANEL_DEVICE, O_RDWR | O_NONBLOCK);
-#else
-	touchpanel_event_fd = open("/dev/input/touchscreen0", O_RDWR | O_NONBLOCK);
-#endif
+	int clockId = CLOCK_MONOTONIC;
+	int i, numSwitched;
 
-	if (touchpanel_event_fd < 0)
+	for (numSwitched = 0; numSwitched < sNumInputs; numSwitched++)
 	{
-		nyx_error(MSGID_NYX_MOD_TP_OPEN_ERR, 0,"Error in opening touchpanel event device");
-		return -1;
+		if (ioctl(sInputs[numSwitched].fd, EVIOCSCLOCKID, &clockId) < 0)
+		{
+			nyx_warn(MSGID_NYX_MOD_TP_CLOCK, 0,
+			         "Touch events stay on CLOCK_REALTIME, EVIOCSCLOCKID failed on input %d: %s",
+			         numSwitched, strerror(errno));
+			break;
+		}
 	}
 
-	ret = ioctl(touchpanel_event_fd, EVIOCGABS(0), &abs);
-
-	if (ret < 0)
+	if (numSwitched < sNumInputs)
 	{
-		nyx_error(MSGID_NYX_MOD_TP_EVENT_HLIMIT_ERR, 0,"Error in fetching screen horizontal limits");
-		goto error;
+		clockId = CLOCK_REALTIME;
+
+		for (i = 0; i < numSwitched; i++)
+		{
+			if (ioctl(sInputs[i].fd, EVIOCSCLOCKID, &clockId) < 0)
+			{
+				nyx_error(MSGID_NYX_MOD_TP_CLOCK, 0,
+				          "Input %d cannot return to CLOCK_REALTIME: %s", i,
+				          strerror(errno));
+			}
+		}
 	}
 
-	maxX = abs.maximum;
+	sEventClock = numSwitched < sNumInputs ? CLOCK_REALTIME : CLOCK_MONOTONIC;
+	latency_set_clock(sEventClock);
+}
 
-	ret = ioctl(touchpanel_event_fd, EVIOCGABS(1), &abs);
+/* the multitouch codes handle_new_mt_event() uses, on type A devices as well */
+static const unsigned int sMultiTouchAbs[] =
+{
+	ABS_MT_SLOT, ABS_MT_TRACKING_ID, ABS_MT_POSITION_X, ABS_MT_POSITION_Y,
+	ABS_MT_TOUCH_MAJOR, ABS_MT_TOUCH_MINOR, ABS_MT_WIDTH_MAJOR, ABS_MT_WIDTH_MINOR,
+	ABS_MT_ORIENTATION
+};
 
-	if (ret < 0)
+/*
+ * Keep what the handler of the input ignores, such as the single touch
+ * emulation of a multitouch panel, out of the kernel queue. Events are still
+ * checked as they come, so an old kernel only costs extra reads.
+ */
+static void
+init_event_filter(touch_input_t *input)
+{
+	static const evdev_filter_t multiTouchFilter =
 	{
-		nyx_error(MSGID_NYX_MOD_TP_EVENT_VLIMIT_ERR, 0, "Error in fetching screen vertical limits");
-		goto error;
-	}
+		EV_ABS, sMultiTouchAbs, sizeof(sMultiTouchAbs) / sizeof(sMultiTouchAbs[0])
+	};
+	int ret;
 
-	maxY = abs.maximum;
+	if (input->mtdev)
+	{
+		ret = evdev_set_filter(input->fd, &multiTouchFilter, 1);
+	}
+	else
+	{
+		ret = filter_single_touch_events(input->fd);
+	}
 
-	// The following function is valid only for virtualbox qemux86 image
-	init_vbox_touchpanel();
-	init_gesture_state_machine(&sGeneralSettings, 1);
+	if (ret < 0)
+	{
+		nyx_debug("[touchpanel] Input %d is not filtered by the kernel: %s",
+		          input->index, strerror(errno));
+	}
+}
 
-	/* Get the display resolution */
-	if (get_display_res(&sXres, &sYres) < 0)
+/*
+ * Map device coordinates onto the display through the configured calibration,
+ * falling back to plain scaling if it cannot be represented.
+ */
+static int
+init_coord_transform(touch_input_t *input, int maxX, int maxY, int xres,
+                     int yres)
+{
+	if (coord_transform_init(&input->transform, maxX, maxY, xres, yres,
+	                         sCalibration) == 0)
 	{
-		nyx_error(MSGID_NYX_MOD_TP_RES_ERR, 0, "Failed to get display resolution");
-		goto error;
+		return 0;
 	}
 
-	scaleX = (float)sXres / (float)maxX;
-	scaleY = (float)sYres / (float)maxY;
+	nyx_warn(MSGID_NYX_MOD_TP_CALIBRATION, 0,
+	         "Unusable calibration matrix, touches are only scaled");
+	return coord_transform_init(&input->transform, maxX, maxY, xres, yres, NULL);
+}
 
-    /* initialize the mtdev instance for this touchscreen */
-    ts_mtdev = mtdev_new_open(touchpanel_event_fd);
-    if (ts_mtdev)
-    {
-        nyx_debug("[touchpanel] mtdev initialized.");
-        int iSlot = 0;
-        mt_slots = (mt_slot_t *)calloc(sizeof(mt_slot_t), MAX_MT_SLOTS);
-        for (; iSlot < MAX_MT_SLOTS; iSlot++)
-        {
-            mt_slots[iSlot].tracking_id = -1;
-            mt_slots[iSlot].previous_tracking_id = -1;
-            mt_slots[iSlot].nyx_finger = -1;
-        }
-    }
+static void
+close_touch_input(touch_input_t *input)
+{
+	if (input->mtdev)
+	{
+		mtdev_close_delete(input->mtdev);
+		input->mtdev = NULL;
+	}
 
-	return 0;
-error:
+	free_mt_slots(&input->slots);
 
-	if (touchpanel_event_fd >= 0)
+	if (input->fd >= 0)
 	{
-		close(touchpanel_event_fd);
+		close(input->fd);
+		input->fd = -1;
 	}
-
-	return ret;
 }
 
-
-nyx_error_t nyx_module_open(nyx_instance_t i, nyx_device_t **d)
+/*
+ * Open one touch device as input number index. Returns the number of slots
+ * it needs in the finger table, or -1 if it cannot be used.
+ */
+static int
+open_touch_input(touch_input_t *input, int index, const char *path, int xres,
+                 int yres)
 {
+	struct input_absinfo abs;
+	int maxX, maxY;
+	int numSlots = DEFAULT_MT_SLOTS;
 
-	touchpanel_device_t *touchpanel_device = (touchpanel_device_t *) calloc(
-	            sizeof(touchpanel_device_t), 1);
+	memset(input, 0, sizeof(*input));
+	input->index = index;
+	input->fd = open(path, O_RDWR | O_NONBLOCK);
 
-	if (G_UNLIKELY(!touchpanel_device))
+	if (input->fd < 0)
 	{
-		nyx_error(MSGID_NYX_MOD_TP_OUT_OF_MEMORY, 0, "Out of memory");
-		return NYX_ERROR_OUT_OF_MEMORY;
+		nyx_error(MSGID_NYX_MOD_TP_OPEN_ERR, 0,"Error in opening touchpanel event device %s",
+		          path);
+		return -1;
 	}
 
-
+	if (ioctl(input->fd, EVIOCGABS(0), &abs) < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_EVENT_HLIMIT_ERR, 0,"Error in fetching screen horizontal limits");
+		goto error;
+	}
+
+	maxX = abs.maximum;
+
+	if (ioctl(input->fd, EVIOCGABS(1), &abs) < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_EVENT_VLIMIT_ERR, 0, "Error in fetching screen vertical limits");
+		goto error;
+	}
+
+	maxY = abs.maximum;
+
+	if (init_coord_transform(input, maxX, maxY, xres, yres) < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_CALIBRATION, 0,
+		          "Invalid touchpanel range %dx%d", maxX, maxY);
+		goto error;
+	}
+
+	/* initialize the mtdev instance for this touchscreen */
+	input->mtdev = mtdev_new_open(input->fd);
+
+	if (input->mtdev)
+	{
+		nyx_debug("[touchpanel] mtdev initialized for %s.", path);
+
+		if (ioctl(input->fd, EVIOCGABS(ABS_MT_SLOT), &abs) == 0)
+		{
+			numSlots = abs.maximum + 1;
+		}
+
+		if (numSlots < 1 || numSlots > MAX_MT_SLOTS)
+		{
+			nyx_warn(MSGID_NYX_MOD_TP_SLOTS, 0, "Device reports %d slots, using %d",
+			         numSlots, numSlots < 1 ? DEFAULT_MT_SLOTS : MAX_MT_SLOTS);
+			numSlots = numSlots < 1 ? DEFAULT_MT_SLOTS : MAX_MT_SLOTS;
+		}
+
+		if (init_mt_slots(&input->slots, numSlots) < 0)
+		{
+			nyx_error(MSGID_NYX_MOD_TP_OUT_OF_MEMORY, 0, "Out of memory");
+			goto error;
+		}
+
+		nyx_debug("[touchpanel] %d multitouch slots", numSlots);
+	}
+
+	init_event_filter(input);
+
+	return numSlots;
+
+error:
+	close_touch_input(input);
+	return -1;
+}
+
+/*
+ * The device went away: lift whatever was down on it and take it out of the
+ * epoll set, the other panels keep working.
+ */
+/* Queue a frame releasing the contacts of a detached input, see read_device() */
+static void
+handle_release_event(touch_input_t *input, input_event_t *event)
+{
+	size_t filled = touchpanel_event_list.input_filled;
+
+	if (input->slots.count)
+	{
+		handle_new_mt_event(input, event);
+	}
+	else
+	{
+		handle_new_event(input, event);
+	}
+
+	if (touchpanel_event_list.input_filled != filled)
+	{
+		latency_frame_queued(&touchpanel_event_list.latency, &event->time);
+	}
+}
+
+static void
+detach_touch_input(touch_input_t *input)
+{
+	input_event_t event;
+	struct timespec now;
+	int iSlot;
+
+	nyx_warn(MSGID_NYX_MOD_TP_INPUTS, 0, "Touch input %d went away", input->index);
+
+	clock_gettime(sEventClock, &now);
+	memset(&event, 0, sizeof(event));
+	event.time.tv_sec = now.tv_sec;
+	event.time.tv_usec = now.tv_nsec / 1000;
+
+	if (input->slots.count)
+	{
+		for (iSlot = 0; iSlot < input->slots.count; iSlot++)
+		{
+			input->slots.tracking_id[iSlot] = -1;
+		}
+
+		event.type = EV_SYN;
+		event.code = SYN_REPORT;
+		handle_release_event(input, &event);
+	}
+	else if (input->cachedButtonState)
+	{
+		event.type = EV_KEY;
+		event.code = BTN_TOUCH;
+		event.value = 0;
+		handle_release_event(input, &event);
+		event.type = EV_SYN;
+		event.code = SYN_REPORT;
+		handle_release_event(input, &event);
+	}
+
+	epoll_ctl(sEpollFd, EPOLL_CTL_DEL, input->fd, NULL);
+	close_touch_input(input);
+}
+
+static void
+close_touch_inputs(void)
+{
+	int i;
+
+	for (i = 0; i < sNumInputs; i++)
+	{
+		close_touch_input(&sInputs[i]);
+	}
+
+	sNumInputs = 0;
+
+	if (sEpollFd >= 0)
+	{
+		close(sEpollFd);
+		sEpollFd = -1;
+	}
+}
+
+/*
+ * Open every configured touch device and gather them in one epoll set.
+ * Returns the total number of slots, or -1 if no device could be opened.
+ */
+static int
+open_touch_inputs(int xres, int yres)
+{
+	struct epoll_event ev;
+	int i, numSlots, totalSlots = 0;
+
+	sEpollFd = epoll_create1(EPOLL_CLOEXEC);
+
+	if (sEpollFd < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_INPUTS, 0, "Failed to create epoll set: %s",
+		          strerror(errno));
+		return -1;
+	}
+
+	for (i = 0; sInputPaths[i] != NULL; i++)
+	{
+		touch_input_t *input = &sInputs[sNumInputs];
+
+		if (sNumInputs == MAX_TOUCH_INPUTS)
+		{
+			nyx_warn(MSGID_NYX_MOD_TP_INPUTS, 0, "Ignoring touch inputs past %d",
+			         MAX_TOUCH_INPUTS);
+			break;
+		}
+
+		numSlots = open_touch_input(input, sNumInputs, sInputPaths[i], xres, yres);
+
+		if (numSlots < 0)
+		{
+			continue;
+		}
+
+		ev.events = EPOLLIN;
+		ev.data.ptr = input;
+
+		if (epoll_ctl(sEpollFd, EPOLL_CTL_ADD, input->fd, &ev) < 0)
+		{
+			nyx_error(MSGID_NYX_MOD_TP_INPUTS, 0, "Failed to watch %s: %s",
+			          sInputPaths[i], strerror(errno));
+			close_touch_input(input);
+			continue;
+		}
+
+		nyx_debug("[touchpanel] input %d is %s", sNumInputs, sInputPaths[i]);
+		totalSlots += numSlots;
+		sNumInputs++;
+	}
+
+	if (0 == sNumInputs)
+	{
+		close_touch_inputs();
+		return -1;
+	}
+
+	init_event_clock();
+
+	return totalSlots;
+}
+
+static int
+init_touchpanel(void)
+{
+	int sXres, sYres;
+	int numSlots;
+
+	load_touchpanel_settings(&sGeneralSettings);
+
+	/* Get the display resolution */
+	if (get_display_res(&sXres, &sYres) < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_RES_ERR, 0, "Failed to get display resolution");
+		return -1;
+	}
+
+	numSlots = open_touch_inputs(sXres, sYres);
+
+	if (numSlots < 0)
+	{
+		return -1;
+	}
+
+	// The following function is valid only for virtualbox qemux86 image
+	init_vbox_touchpanel();
+
+	if (init_event_list(numSlots) < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_OUT_OF_MEMORY, 0, "Out of memory");
+		close_touch_inputs();
+		return -1;
+	}
+
+	init_gesture_state_machine(&sGeneralSettings, numSlots);
+
+	if (scan_rate_init(&sScanRate, sScanRatePath,
+	                   sActiveScanRate > 0 ? sActiveScanRate : 0, &sIdleSettings) < 0)
+	{
+		nyx_warn(MSGID_NYX_MOD_TP_SCAN_RATE, 0, "Scan rate control unavailable");
+	}
+
+	if (sGeneralSettings.readerThread && start_reader_thread(numSlots) < 0)
+	{
+		nyx_warn(MSGID_NYX_MOD_TP_READER, 0,
+		         "Reader thread unavailable, reading touch events synchronously");
+	}
+
+	return 0;
+}
+
+
+nyx_error_t nyx_module_open(nyx_instance_t i, nyx_device_t **d)
+{
+
+	touchpanel_device_t *touchpanel_device = (touchpanel_device_t *) calloc(
+	            sizeof(touchpanel_device_t), 1);
+
+	if (G_UNLIKELY(!touchpanel_device))
+	{
+		nyx_error(MSGID_NYX_MOD_TP_OUT_OF_MEMORY, 0, "Out of memory");
+		return NYX_ERROR_OUT_OF_MEMORY;
+	}
+
+
 	nyx_module_register_method(i, (nyx_device_t *) touchpanel_device,
 	                                     NYX_GET_EVENT_SOURCE_MODULE_METHOD, "touchpanel_get_event_source");
 
@@ -499,6 +1340,8 @@ nyx_error_t nyx_module_open(nyx_instance_t i, nyx_device_t **d)
 	nyx_module_register_method(i, (nyx_device_t *) touchpanel_device,
 	                           NYX_TOUCHPANEL_GET_MODE_MODULE_METHOD, "touchpanel_get_mode");
 
+	touch_event_pool_init(&touchpanel_device->event_pool);
+
 	*d = (nyx_device_t *) touchpanel_device;
 
 	if (init_touchpanel() < 0)
@@ -525,24 +1368,55 @@ nyx_error_t nyx_module_close(nyx_device_t *d)
 
 	nyx_debug("Freeing touchpanel %p", d);
 
-	deinit_gesture_state_machine();
-	free(d);
+	/* the reader thread uses everything below, stop it first */
+	stop_reader_thread();
+	scan_rate_deinit(&sScanRate);
+	g_free(sScanRatePath);
+	sScanRatePath = NULL;
+	touchpanel_dump_latency(d);
+
+	if (touchpanel_device->event_pool.exhausted)
+	{
+		nyx_info(MSGID_NYX_MOD_TP_EVENT_POOL_EXHAUSTED, 0,
+		         "Touch event pool (%d events) was exhausted %lu times",
+		         TOUCH_EVENT_POOL_SIZE, touchpanel_device->event_pool.exhausted);
+	}
+
+	if (sReadStats.frames)
+	{
+		nyx_info(MSGID_NYX_MOD_TP_READ_STATS, 0,
+		         "%lu events, %lu frames in %lu read syscalls (%.2f syscalls per frame)",
+		         sReadStats.events, sReadStats.frames, sReadStats.syscalls,
+		         (double) sReadStats.syscalls / sReadStats.frames);
+	}
 
-	if(ts_mtdev)
+	if (sReadStats.coalesced)
 	{
-		mtdev_close_delete(ts_mtdev);
+		nyx_info(MSGID_NYX_MOD_TP_COALESCED, 0, "%lu moves coalesced",
+		         sReadStats.coalesced);
 	}
-	if(mt_slots)
+
+	if (sReadStats.palms)
 	{
-		free(mt_slots);
+		nyx_info(MSGID_NYX_MOD_TP_PALM, 0, "%lu contacts rejected as palms",
+		         sReadStats.palms);
 	}
 
-	if (touchpanel_event_fd >= 0)
+	if (sReadStats.drops)
 	{
-		close(touchpanel_event_fd);
-		touchpanel_event_fd = -1;
+		nyx_info(MSGID_NYX_MOD_TP_SYN_DROPPED, 0,
+		         "%lu drops, %lu events discarded, %lu resyncs",
+		         sReadStats.drops, sReadStats.discarded, sReadStats.resyncs);
 	}
 
+	deinit_gesture_state_machine();
+	free(d);
+
+	close_touch_inputs();
+	g_strfreev(sInputPaths);
+	sInputPaths = NULL;
+	free_event_list();
+
 
 	return NYX_ERROR_NONE;
 }
@@ -560,7 +1434,7 @@ nyx_error_t touchpanel_get_event_source(nyx_device_t *d, int *f)
 		return NYX_ERROR_INVALID_VALUE;
 	}
 
-	*f = touchpanel_event_fd;
+	*f = sReader.running ? sReader.readyFd : sEpollFd;
 
 	return NYX_ERROR_NONE;
 }
@@ -571,29 +1445,30 @@ nyx_error_t touchpanel_set_operating_mode(nyx_device_t *d,
 	return NYX_ERROR_NOT_IMPLEMENTED;
 }
 
-void
-get_time_stamp(time_stamp_t *pTime)
+/*
+ * The gesture state machine runs on the time the kernel captured the event
+ * at, not when we got around to processing it, so scheduling jitter stays out
+ * of the velocity and flick computations.
+ */
+static void
+event_time_stamp(const struct timeval *tv, time_stamp_t *pTime)
 {
-	struct timeval tv;
-	(void)gettimeofday(&tv, NULL);
-
-	pTime->time.tv_sec = tv.tv_sec;
-	pTime->time.tv_nsec = tv.tv_usec * 1000;
+	pTime->time.tv_sec = tv->tv_sec;
+	pTime->time.tv_nsec = tv->tv_usec * 1000;
 }
 
 
-int cachedX, cachedY;
-
 static void
-generate_mouse_gesture(int touchButtonState)
+generate_mouse_gesture(touch_input_t *input, int touchButtonState,
+                       const struct timeval *time)
 {
 	int32_t xOrd[2], yOrd[2], wOrd[2], fingers;
 	time_stamp_t eventTime;
 	int num_events = 0;
 
-	get_time_stamp(&eventTime);
-	xOrd[0] = cachedX;
-	yOrd[0] = cachedY;
+	event_time_stamp(time, &eventTime);
+	coord_transform_apply(&input->transform, input->cachedX, input->cachedY,
+	                      &xOrd[0], &yOrd[0]);
 	wOrd[0] = touchButtonState ? 1 : 0;
 	fingers = touchButtonState ? 1 : 0;
 
@@ -602,11 +1477,11 @@ generate_mouse_gesture(int touchButtonState)
 	wOrd[1] = 0;
 
 	/* track this new coordinate */
-	gesture_state_machine(xOrd, yOrd, wOrd, fingers, &eventTime,
-	                      touchpanel_event_list.input, &num_events);
+	gesture_state_machine(input->index, xOrd, yOrd, wOrd, fingers, &eventTime,
+	                      touchpanel_event_list.input + touchpanel_event_list.input_filled /
+	                      sizeof(input_event_t), event_list_room(), &num_events);
 	/* process the modifications */
-	touchpanel_event_list.input_filled = num_events * sizeof(input_event_t);
-	touchpanel_event_list.input_read = 0;
+	touchpanel_event_list.input_filled += num_events * sizeof(input_event_t);
 }
 
 
@@ -616,12 +1491,94 @@ generate_mouse_gesture(int touchButtonState)
  */
 #define SYN_START       8
 
-static void handle_new_mt_event(input_event_t *event)
+/*
+ * Palm rejection: contacts larger than the configured touch or width major
+ * (device units, 0 disables the check) never reach the gesture machine.
+ */
+static bool
+is_palm_contact(const mt_slots_t *slots, int iSlot)
+{
+	return (sGeneralSettings.maxTouchMajor > 0 &&
+	        slots->touchMajor[iSlot] > sGeneralSettings.maxTouchMajor) ||
+	       (sGeneralSettings.maxWidthMajor > 0 &&
+	        slots->widthMajor[iSlot] > sGeneralSettings.maxWidthMajor);
+}
+
+static void
+add_slot_finger(touch_input_t *input, int iSlot, const time_stamp_t *pTime)
+{
+	mt_slots_t *slots = &input->slots;
+	finger_t *finger;
+
+	if (is_palm_contact(slots, iSlot))
+	{
+		nyx_debug("[touchpanel] reject palm in slot %d", iSlot);
+		slots->nyx_finger[iSlot] = NULL;
+		slots->rejected[iSlot] = 1;
+		sReadStats.palms++;
+		return;
+	}
+
+	finger = add_new_finger(slots->posX[iSlot], slots->posY[iSlot], 1, pTime);
+
+	if (finger)
+	{
+		finger->device = input->index;
+	}
+
+	slots->nyx_finger[iSlot] = finger;
+	slots->rejected[iSlot] = 0;
+}
+
+static void
+release_slot_finger(mt_slots_t *slots, int iSlot, const time_stamp_t *pTime)
+{
+	if (!slots->rejected[iSlot])
+	{
+		update_finger(slots->nyx_finger[iSlot], slots->posX[iSlot],
+		              slots->posY[iSlot], 0, pTime);
+	}
+
+	slots->nyx_finger[iSlot] = NULL;
+	slots->rejected[iSlot] = 0;
+}
+
+/*
+ * Store a raw slot coordinate, flagging the slot when the value really
+ * changed; only flagged slots are transformed and delta frames skip the
+ * others.
+ */
+static void
+set_slot_position(mt_slots_t *slots, int *pPos, int value, int iSlot)
 {
-	static int currentSlot = 0;
+	if (*pPos != value)
+	{
+		*pPos = value;
+		slots->dirty[iSlot] = 1;
+	}
+}
+
+/* Contacts down on all the devices, for the scan rate control */
+static int
+total_contacts(void)
+{
+	int i, contacts = 0;
+
+	for (i = 0; i < sNumInputs; i++)
+	{
+		contacts += sInputs[i].contacts;
+	}
+
+	return contacts;
+}
+
+static void handle_new_mt_event(touch_input_t *input, input_event_t *event)
+{
+	mt_slots_t *slots = &input->slots;
+	int currentSlot;
 
-	/* safety check */
-	if ((NULL == ts_mtdev) || (NULL == mt_slots))
+	/* safety check, the replay tool drives the slots without an mtdev */
+	if (0 == slots->count)
 		return;
 
 	nyx_debug("[touchpanel] ABS=%x KEY=%x,SYN=%x", EV_ABS, EV_KEY, EV_SYN);
@@ -629,95 +1586,155 @@ static void handle_new_mt_event(input_event_t *event)
 
 	/* if the current slot has changed, it should be the first thing we get */
 	if ((event->type == EV_ABS) && (event->code == ABS_MT_SLOT))
-		currentSlot = (int) (event->value);
+		input->currentSlot = (int) (event->value);
+
+	currentSlot = input->currentSlot;
 
 	/* if the current slot is not valid, then skip the event */
-	if (currentSlot < 0 || currentSlot >= MAX_MT_SLOTS)
+	if (currentSlot < 0 || currentSlot >= slots->count)
 		return;
 
 	if ((event->type == EV_ABS) && (event->code == ABS_MT_TRACKING_ID))
-		mt_slots[currentSlot].tracking_id = (int) (event->value);
+		slots->tracking_id[currentSlot] = (int) (event->value);
 
     else if ((event->type == EV_ABS) && (event->code == ABS_MT_POSITION_X))
-            mt_slots[currentSlot].posX =  (int) (event->value * scaleX);
+            set_slot_position(slots, &slots->rawX[currentSlot], (int) (event->value), currentSlot);
 
     else if ((event->type == EV_ABS) && (event->code == ABS_MT_POSITION_Y))
-            mt_slots[currentSlot].posY = (int) (event->value * scaleY);
+            set_slot_position(slots, &slots->rawY[currentSlot], (int) (event->value), currentSlot);
+
+	else if ((event->type == EV_ABS) && (event->code == ABS_MT_TOUCH_MAJOR))
+		slots->touchMajor[currentSlot] = (int) (event->value);
+
+	else if ((event->type == EV_ABS) && (event->code == ABS_MT_TOUCH_MINOR))
+		slots->touchMinor[currentSlot] = (int) (event->value);
+
+	else if ((event->type == EV_ABS) && (event->code == ABS_MT_WIDTH_MAJOR))
+		slots->widthMajor[currentSlot] = (int) (event->value);
+
+	else if ((event->type == EV_ABS) && (event->code == ABS_MT_WIDTH_MINOR))
+		slots->widthMinor[currentSlot] = (int) (event->value);
+
+	else if ((event->type == EV_ABS) && (event->code == ABS_MT_ORIENTATION))
+		slots->orientation[currentSlot] = (int) (event->value);
 
 	else if (event->type == EV_SYN && event->code == SYN_REPORT)
     {
         int num_events=0;
+        int numContacts = 0;
+        sReadStats.frames++;
         time_stamp_t eventTime;
-        get_time_stamp(&eventTime);
+        event_time_stamp(&event->time, &eventTime);
 
 		/* Now process all the changes */
 		int iSlot = 0;
-        for( ; iSlot < MAX_MT_SLOTS; iSlot++ )
+        for( ; iSlot < slots->count; iSlot++ )
         {
-            if((mt_slots[iSlot].tracking_id != -1) && (mt_slots[iSlot].previous_tracking_id == -1))
+            if (slots->tracking_id[iSlot] != -1)
+                numContacts++;
+
+			if (slots->dirty[iSlot])
+			{
+				coord_transform_apply(&input->transform, slots->rawX[iSlot],
+				                      slots->rawY[iSlot], &slots->posX[iSlot],
+				                      &slots->posY[iSlot]);
+			}
+
+            if((slots->tracking_id[iSlot] != -1) && (slots->previous_tracking_id[iSlot] == -1))
 			{
 				/* a new finger has appeared */
 				nyx_debug("[touchpanel] new finger");
-				mt_slots[iSlot].nyx_finger = add_new_finger(mt_slots[iSlot].posX, mt_slots[iSlot].posY, 1, &eventTime);
-				mt_slots[iSlot].previous_tracking_id = mt_slots[iSlot].tracking_id;
+				add_slot_finger(input, iSlot, &eventTime);
+				slots->previous_tracking_id[iSlot] = slots->tracking_id[iSlot];
 			}
-			else if((mt_slots[iSlot].tracking_id == -1) && (mt_slots[iSlot].previous_tracking_id != -1))
+			else if((slots->tracking_id[iSlot] == -1) && (slots->previous_tracking_id[iSlot] != -1))
 			{
 				/* a finger has been released */
 				nyx_debug("[touchpanel] release finger");
-				update_finger(mt_slots[iSlot].nyx_finger, mt_slots[iSlot].posX, mt_slots[iSlot].posY, 0, &eventTime);
-
-				mt_slots[iSlot].nyx_finger = NULL;
-				mt_slots[iSlot].previous_tracking_id = mt_slots[iSlot].tracking_id;
+				release_slot_finger(slots, iSlot, &eventTime);
+				slots->previous_tracking_id[iSlot] = slots->tracking_id[iSlot];
 			}
-			else if(mt_slots[iSlot].tracking_id != -1)
+			else if((slots->tracking_id[iSlot] != -1) &&
+			        (slots->tracking_id[iSlot] != slots->previous_tracking_id[iSlot]))
 			{
-				nyx_debug("[touchpanel] update finger");
-				/* simple move gesture */
-				update_finger(mt_slots[iSlot].nyx_finger, mt_slots[iSlot].posX, mt_slots[iSlot].posY, 1, &eventTime);
+				/*
+				 * the contact was replaced without an intermediate release, either
+				 * within one frame or while events were dropped
+				 */
+				nyx_debug("[touchpanel] replace finger");
+				release_slot_finger(slots, iSlot, &eventTime);
+				add_slot_finger(input, iSlot, &eventTime);
+				slots->previous_tracking_id[iSlot] = slots->tracking_id[iSlot];
 			}
+			else if((slots->tracking_id[iSlot] != -1) && !slots->rejected[iSlot])
+			{
+				/* palms stay out of the gesture machine until lifted */
+				if (is_palm_contact(slots, iSlot))
+				{
+					/* the contact grew into a palm, cancel its finger */
+					nyx_debug("[touchpanel] reject grown contact");
+					release_slot_finger(slots, iSlot, &eventTime);
+					slots->rejected[iSlot] = 1;
+					sReadStats.palms++;
+				}
+				else
+				{
+					/*
+					 * resting contacts are fed as well, the position filter keeps
+					 * converging on them; delta frames leave a finger out once its
+					 * reported position stops changing
+					 */
+					nyx_debug("[touchpanel] update finger");
+					update_finger(slots->nyx_finger[iSlot], slots->posX[iSlot], slots->posY[iSlot], 1, &eventTime);
+				}
+			}
+
+			slots->dirty[iSlot] = 0;
         }
 
-		gesture_state_machine_process(&eventTime, touchpanel_event_list.input+touchpanel_event_list.input_filled/sizeof(input_event_t), &num_events);
+		input->contacts = numContacts;
+		scan_rate_contacts(&sScanRate, total_contacts());
+		gesture_state_machine_process(&eventTime, touchpanel_event_list.input+touchpanel_event_list.input_filled/sizeof(input_event_t), event_list_room(), &num_events);
 	    touchpanel_event_list.input_filled+=num_events * sizeof(input_event_t);
     }
 }
 
-static void handle_new_event(input_event_t *event)
+static void handle_new_event(touch_input_t *input, input_event_t *event)
 {
-	static int touchButtonState = 0;
-
-	// Truncate scaled X & Y coordinate values
+	// Raw X & Y coordinates, transformed when the gesture is generated
 	if ((event->type == EV_ABS) && (event->code == ABS_X))
 	{
-		cachedX = (int)(event->value * scaleX);
+		input->cachedX = (int)(event->value);
 	}
 
 	else if ((event->type == EV_ABS) && (event->code == ABS_Y))
 	{
-		cachedY = (int)(event->value * scaleY);
+		input->cachedY = (int)(event->value);
 	}
 
 	// qemu touchpanel sends BTN_TOUCH, virtualbox touchpanel sends BTN_LEFT
 	else if ((event->type == EV_KEY) && ((event->code == BTN_TOUCH) ||
 	                                     (event->code == BTN_LEFT)))
 	{
-		// save touchButtonState (up or down)
-		touchButtonState = event->value;
+		// save touch button state (up or down)
+		input->cachedButtonState = event->value;
 
-		if (touchButtonState == 0)
+		if (input->cachedButtonState == 0)
 		{
 			/* generate another event with the coordinates and time of the
 			* release point so that we can calculate how long the mouse
 			* button has been down in the same spot and not create flicks
 			* if it has been down for long enough
 			*/
-			generate_mouse_gesture(1);
+			generate_mouse_gesture(input, 1, &event->time);
 		}
 	}
 	else if (event->type == EV_SYN)
 	{
-		generate_mouse_gesture(touchButtonState);
+		sReadStats.frames++;
+		input->contacts = input->cachedButtonState ? 1 : 0;
+		scan_rate_contacts(&sScanRate, total_contacts());
+		generate_mouse_gesture(input, input->cachedButtonState, &event->time);
 	}
 
 	if ((event->type == EV_REL && event->code == REL_WHEEL) ||
@@ -726,104 +1743,859 @@ static void handle_new_event(input_event_t *event)
 	                                   event->code == BTN_EXTRA || event->code == BTN_FORWARD ||
 	                                   event->code == BTN_BACK || event->code == BTN_TASK)))
 	{
-		memcpy(&touchpanel_event_list.input[0], event, sizeof(input_event_t));
+		size_t filled = touchpanel_event_list.input_filled / sizeof(input_event_t);
+
+		memcpy(&touchpanel_event_list.input[filled], event, sizeof(input_event_t));
 		// Forward an EV_SYN after the key event, to make sure it is processed immediately.
 		input_event_t syn_event;
 		syn_event.type = EV_SYN;
 		syn_event.code = SYN_START;
 		syn_event.value = 0;
 
-		memcpy(&touchpanel_event_list.input[1], &syn_event, sizeof(input_event_t));
+		memcpy(&touchpanel_event_list.input[filled + 1], &syn_event,
+		       sizeof(input_event_t));
 
-		touchpanel_event_list.input_filled = 2 * sizeof(input_event_t);
-		touchpanel_event_list.input_read = 0;
+		touchpanel_event_list.input_filled += 2 * sizeof(input_event_t);
 	}
 
 	return;
 }
 
-static struct pollfd fds[1];
+/* Worst case number of events one single-touch input event (mouse gesture or
+ * wheel key) can add to the event list, with the room the gesture machine
+ * keeps for a multi-finger gesture */
+#define MAX_EVENTS_PER_ST_INPUT     (MAX_EVENTS_PER_FINGER + \
+                                     MAX_EVENTS_PER_GESTURE + 1)
+
+static input_event_t raw_events[MAX_RAW_EVENTS];
 
+/*
+ * Read as many pending events as fit in pEvents with one read() call.
+ * Returns the number of events read, 0 if nothing could be read, -1 once the
+ * device is gone.
+ */
 static int
-read_input_event(void)
+drain_device(touch_input_t *input, input_event_t *pEvents, size_t maxEvents)
 {
-	int numEvents = 0;
-	int rd = 0;
-	input_event_t pEvent;
+	ssize_t rd;
 
-	fds[0].fd = touchpanel_event_fd;
-	fds[0].events = POLLIN;
+	if (maxEvents == 0)
+	{
+		return 0;
+	}
 
-	/* read events through mtdev (which can also handle singletouch events) */
-	if (ts_mtdev)
+	do
 	{
-		touchpanel_event_list.input_filled=0;
-      	touchpanel_event_list.input_read=0;
+		rd = read(input->fd, pEvents, maxEvents * sizeof(input_event_t));
+		sReadStats.syscalls++;
+	}
+	while (rd < 0 && errno == EINTR);
 
-		if (!mtdev_idle(ts_mtdev, touchpanel_event_fd, 0))
+	if (rd < 0)
+	{
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
 		{
-			while (mtdev_get(ts_mtdev, touchpanel_event_fd, (struct input_event *)&pEvent, 1) > 0)
-			{
-				numEvents++;
-				handle_new_mt_event(&pEvent);
-			}
+			return 0;
 		}
+
+		if (errno == ENODEV)
+		{
+			return -1;
+		}
+
+		nyx_error(MSGID_NYX_MOD_TP_EVT_READ_ERR, 0, "Failed to read events from touchpanel event file");
+		return 0;
+	}
+
+	sReadStats.events += rd / sizeof(input_event_t);
+
+	return rd / sizeof(input_event_t);
+}
+
+/*
+ * SYN_DROPPED recovery. When the evdev client buffer overflows the kernel
+ * drops events and reports SYN_DROPPED; everything up to the next SYN_REPORT
+ * is incomplete and is discarded. The current device state is then read back
+ * and fed through the normal path as synthesized frames, so fingers lifted or
+ * placed in the meantime produce proper up/down transitions.
+ */
+#define NBITS(x)            ((((x) - 1) / (sizeof(long) * 8)) + 1)
+#define TEST_BIT(bit, array) \
+	((array[(bit) / (sizeof(long) * 8)] >> ((bit) % (sizeof(long) * 8))) & 1)
+
+/* one frame with slot, tracking id and position for every slot */
+#define MAX_RESYNC_EVENTS   (MAX_MT_SLOTS * 6 + 3)
+
+/*
+ * Size of the mtdev event queues (DIM_EVENTS, not exported). They do not
+ * guard against overruns: no more than this may be fed to mtdev before it
+ * was emptied again. A batch of raw events is sized so that a resync still
+ * fits behind it, and ends with the first resync.
+ */
+#define MTDEV_QUEUE_EVENTS  512
+#define MAX_MTDEV_RAW_EVENTS \
+	MIN(MAX_RAW_EVENTS, MTDEV_QUEUE_EVENTS - MAX_RESYNC_EVENTS)
+
+static input_event_t resync_events[MAX_RESYNC_EVENTS];
+
+typedef struct
+{
+	uint32_t code;
+	int32_t values[MAX_MT_SLOTS];
+} mt_slots_request_t;
+
+static void
+set_resync_event(input_event_t *event, const struct timeval *time,
+                 uint16_t type, uint16_t code, int32_t value)
+{
+	event->time = *time;
+	event->type = type;
+	event->code = code;
+	event->value = value;
+}
+
+static int
+get_mt_slot_values(touch_input_t *input, uint32_t code,
+                   mt_slots_request_t *request)
+{
+	request->code = code;
+	return ioctl(input->fd, EVIOCGMTSLOTS(sizeof(*request)), request);
+}
+
+/*
+ * Synthesize the current multitouch state of the device. Type A devices
+ * report every contact in each frame, nothing has to be synthesized there.
+ */
+static int
+resync_mt_state(touch_input_t *input, const struct timeval *time,
+                input_event_t *pEvents)
+{
+	mt_slots_request_t tracking, posX, posY, touchMajor, widthMajor;
+	struct input_absinfo slot;
+	unsigned long keys[NBITS(KEY_MAX + 1)];
+	bool sizes;
+	int iSlot, n = 0;
+
+	if (ioctl(input->fd, EVIOCGABS(ABS_MT_SLOT), &slot) < 0)
+	{
+		return 0;
+	}
+
+	if (get_mt_slot_values(input, ABS_MT_TRACKING_ID, &tracking) < 0 ||
+	        get_mt_slot_values(input, ABS_MT_POSITION_X, &posX) < 0 ||
+	        get_mt_slot_values(input, ABS_MT_POSITION_Y, &posY) < 0 ||
+	        ioctl(input->fd, EVIOCGKEY(sizeof(keys)), keys) < 0)
+	{
+		return -1;
+	}
+
+	/* contact sizes only matter to palm rejection */
+	sizes = (sGeneralSettings.maxTouchMajor > 0 || sGeneralSettings.maxWidthMajor > 0)
+	        && get_mt_slot_values(input, ABS_MT_TOUCH_MAJOR, &touchMajor) == 0
+	        && get_mt_slot_values(input, ABS_MT_WIDTH_MAJOR, &widthMajor) == 0;
+
+	for (iSlot = 0; iSlot < input->slots.count && iSlot <= slot.maximum; iSlot++)
+	{
+		set_resync_event(&pEvents[n++], time, EV_ABS, ABS_MT_SLOT, iSlot);
+		set_resync_event(&pEvents[n++], time, EV_ABS, ABS_MT_TRACKING_ID,
+		                 tracking.values[iSlot]);
+
+		if (tracking.values[iSlot] != -1)
+		{
+			set_resync_event(&pEvents[n++], time, EV_ABS, ABS_MT_POSITION_X,
+			                 posX.values[iSlot]);
+			set_resync_event(&pEvents[n++], time, EV_ABS, ABS_MT_POSITION_Y,
+			                 posY.values[iSlot]);
+
+			if (sizes)
+			{
+				set_resync_event(&pEvents[n++], time, EV_ABS, ABS_MT_TOUCH_MAJOR,
+				                 touchMajor.values[iSlot]);
+				set_resync_event(&pEvents[n++], time, EV_ABS, ABS_MT_WIDTH_MAJOR,
+				                 widthMajor.values[iSlot]);
+			}
+		}
+	}
+
+	/* later events are relative to the slot the device is on */
+	set_resync_event(&pEvents[n++], time, EV_ABS, ABS_MT_SLOT, slot.value);
+	set_resync_event(&pEvents[n++], time, EV_KEY, BTN_TOUCH,
+	                 TEST_BIT(BTN_TOUCH, keys));
+	set_resync_event(&pEvents[n++], time, EV_SYN, SYN_REPORT, 0);
+
+	return n;
+}
+
+/* Synthesize the current singletouch state of the device */
+static int
+resync_st_state(touch_input_t *input, const struct timeval *time,
+                input_event_t *pEvents)
+{
+	struct input_absinfo absX, absY;
+	unsigned long keys[NBITS(KEY_MAX + 1)];
+	int button, n = 0;
+
+	if (ioctl(input->fd, EVIOCGABS(ABS_X), &absX) < 0 ||
+	        ioctl(input->fd, EVIOCGABS(ABS_Y), &absY) < 0 ||
+	        ioctl(input->fd, EVIOCGKEY(sizeof(keys)), keys) < 0)
+	{
+		return -1;
+	}
+
+	set_resync_event(&pEvents[n++], time, EV_ABS, ABS_X, absX.value);
+	set_resync_event(&pEvents[n++], time, EV_ABS, ABS_Y, absY.value);
+
+	/* qemu touchpanel sends BTN_TOUCH, virtualbox touchpanel sends BTN_LEFT */
+	button = TEST_BIT(BTN_TOUCH, keys) || TEST_BIT(BTN_LEFT, keys);
+
+	if (button != input->cachedButtonState)
+	{
+		set_resync_event(&pEvents[n++], time, EV_KEY, BTN_TOUCH, button);
+	}
+
+	set_resync_event(&pEvents[n++], time, EV_SYN, SYN_REPORT, 0);
+
+	return n;
+}
+
+static void
+feed_raw_event(touch_input_t *input, input_event_t *event)
+{
+	if (input->mtdev)
+	{
+		mtdev_put_event(input->mtdev, (struct input_event *)event);
+	}
+	else
+	{
+		size_t filled = touchpanel_event_list.input_filled;
+
+		handle_new_event(input, event);
+
+		if (touchpanel_event_list.input_filled != filled)
+		{
+			latency_frame_queued(&touchpanel_event_list.latency, &event->time);
+		}
+	}
+}
+
+/*
+ * Returns true when the raw event must not be fed to the handlers because it
+ * reports or follows a drop. The SYN_REPORT ending the dropped stretch is
+ * replaced by the synthesized device state.
+ */
+static bool
+filter_dropped_event(touch_input_t *input, input_event_t *event)
+{
+	int n, numResync;
+
+	if (event->type == EV_SYN && event->code == SYN_DROPPED)
+	{
+		if (!input->syncDropped)
+		{
+			sReadStats.drops++;
+			nyx_warn(MSGID_NYX_MOD_TP_SYN_DROPPED, 0,
+			         "Touchpanel events dropped by the kernel (%lu drops)",
+			         sReadStats.drops);
+		}
+
+		input->syncDropped = true;
+		return true;
+	}
+
+	if (!input->syncDropped)
+	{
+		return false;
+	}
+
+	if (event->type != EV_SYN || event->code != SYN_REPORT)
+	{
+		sReadStats.discarded++;
+		return true;
+	}
+
+	input->syncDropped = false;
+
+	numResync = input->mtdev ? resync_mt_state(input, &event->time, resync_events)
+	            : resync_st_state(input, &event->time, resync_events);
+
+	if (numResync < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_RESYNC_ERR, 0,
+		          "Failed to read back touchpanel state after dropped events");
+		return true;
+	}
+
+	sReadStats.resyncs++;
+
+	for (n = 0; n < numResync; n++)
+	{
+		feed_raw_event(input, &resync_events[n]);
+	}
+
+	return true;
+}
+
+static int sFramesKept[LATENCY_QUEUE_FRAMES];
+
+/*
+ * Under backpressure the list holds every frame queued since the previous
+ * drain; only the latest move of each finger is worth delivering.
+ */
+static void
+coalesce_event_list(event_list_t *list)
+{
+	coalesce_scratch_t *scratch = &list->coalesce;
+	int numEvents, numFrames;
+
+	scratch->framesKept = sFramesKept;
+	scratch->maxFrames = LATENCY_QUEUE_FRAMES;
+
+	numEvents = coalesce_moves(list->input,
+	                           list->input_filled / sizeof(input_event_t),
+	                           scratch, &numFrames, &sReadStats.coalesced);
+
+	list->input_filled = numEvents * sizeof(input_event_t);
+	latency_queue_keep(&list->latency, sFramesKept, numFrames);
+}
+
+/* Process what is pending on one device, returns the number of events */
+static int
+read_device(touch_input_t *input)
+{
+	int numEvents = 0;
+	int numRaw, n;
+
+	/* read events through mtdev (which can also handle singletouch events) */
+	if (input->mtdev)
+	{
+		/*
+		 * Only feed kernel events once mtdev has handed out everything it
+		 * converted so far, see MTDEV_QUEUE_EVENTS. Events read but not fed
+		 * yet go in as soon as mtdev is empty again.
+		 */
+		do
+		{
+			if (mtdev_empty(input->mtdev))
+			{
+				unsigned long resyncs = sReadStats.resyncs;
+
+				if (input->rawNext == input->rawCount)
+				{
+					numRaw = drain_device(input, input->raw, MAX_MTDEV_RAW_EVENTS);
+
+					if (numRaw < 0)
+					{
+						return -1;
+					}
+
+					input->rawNext = 0;
+					input->rawCount = numRaw;
+				}
+
+				while (input->rawNext < input->rawCount &&
+				        sReadStats.resyncs == resyncs)
+				{
+					input_event_t *event = &input->raw[input->rawNext++];
+
+					if (!filter_dropped_event(input, event))
+					{
+						feed_raw_event(input, event);
+					}
+				}
+			}
+
+			/* whatever does not fit in the event list stays queued in mtdev */
+			while (!mtdev_empty(input->mtdev) && event_list_room() >= sEventsPerFrame)
+			{
+				input_event_t event;
+
+				size_t filled = touchpanel_event_list.input_filled;
+
+				mtdev_get_event(input->mtdev, (struct input_event *)&event);
+				numEvents++;
+				handle_new_mt_event(input, &event);
+
+				if (touchpanel_event_list.input_filled != filled)
+				{
+					latency_frame_queued(&touchpanel_event_list.latency, &event.time);
+				}
+			}
+		}
+		while (input->rawNext < input->rawCount && mtdev_empty(input->mtdev));
+	}
+	else
+	{
+		/* Fallback on singletouch handling it no mtdev is present */
+		numRaw = drain_device(input, raw_events,
+		                      event_list_room() / MAX_EVENTS_PER_ST_INPUT);
+
+		if (numRaw < 0)
+		{
+			return -1;
+		}
+
+		for (n = 0; n < numRaw; n++)
+		{
+			if (!filter_dropped_event(input, &raw_events[n]))
+			{
+				feed_raw_event(input, &raw_events[n]);
+			}
+		}
+
+		numEvents = numRaw;
+	}
+
+	return numEvents;
+}
+
+/* Take over the settings changed by the nyx methods, on the input path */
+static void
+apply_settings_update(void)
+{
+	settings_update_t *update = &sSettingsUpdate;
+
+	if (0 == __atomic_load_n(&update->changed, __ATOMIC_ACQUIRE))
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&update->lock);
+
+	if (update->changed & SETTINGS_DELTA_FRAMES)
+	{
+		sGeneralSettings.deltaFrames = update->deltaFrames;
+	}
+
+	if (update->changed & SETTINGS_MULTI_FINGER)
+	{
+		sGeneralSettings.multiFingerGestures = update->multiFingerGestures;
+	}
+
+	if (update->changed & SETTINGS_VSYNC)
+	{
+		resample_set_vsync(update->vsyncTime, update->vsyncPeriod);
+	}
+
+	__atomic_store_n(&update->changed, 0, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&update->lock);
+}
+
+/*
+ * Read every device with pending events. A single device is read directly;
+ * with several, the epoll set tells which ones to read, along with those
+ * still holding events read earlier or converted by mtdev.
+ */
+static int
+read_input_event(void)
+{
+	struct epoll_event ready[MAX_TOUCH_INPUTS];
+	bool pending[MAX_TOUCH_INPUTS] = { false };
+	int numEvents = 0;
+	int i, n, numReady = 0;
+	unsigned long syscalls = sReadStats.syscalls;
+	unsigned long frames = sReadStats.frames;
+
+	touchpanel_event_list.input_filled = 0;
+	touchpanel_event_list.input_read = 0;
+	latency_queue_reset(&touchpanel_event_list.latency);
+	apply_settings_update();
+
+	if (sNumInputs > 1)
+	{
+		numReady = epoll_wait(sEpollFd, ready, MAX_TOUCH_INPUTS, 0);
+
+		for (i = 0; i < numReady; i++)
+		{
+			pending[((touch_input_t *) ready[i].data.ptr)->index] = true;
+		}
+	}
+
+	for (i = 0; i < sNumInputs; i++)
+	{
+		touch_input_t *input = &sInputs[i];
+
+		if (input->fd < 0 || (sNumInputs > 1 && !pending[i] &&
+		                      input->rawNext == input->rawCount &&
+		                      !(input->mtdev && !mtdev_empty(input->mtdev))))
+		{
+			continue;
+		}
+
+		n = read_device(input);
+
+		if (n < 0)
+		{
+			detach_touch_input(input);
+			continue;
+		}
+
+		numEvents += n;
+	}
+
+	if (sReadStats.frames != frames)
+	{
+		nyx_debug("[touchpanel] %d events, %lu frames in %lu read syscalls", numEvents,
+		          sReadStats.frames - frames, sReadStats.syscalls - syscalls);
+	}
+
+	return numEvents;
+}
+
+static void
+reader_signal(void)
+{
+	uint64_t one = 1;
+
+	if (write(sReader.readyFd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_READER, 0, "Failed to signal touch frames: %s",
+		          strerror(errno));
+	}
+}
+
+/* Returns true if the thread was asked to stop while waiting */
+static bool
+reader_wait(int timeout)
+{
+	struct pollfd pfd = { .fd = sReader.stopFd, .events = POLLIN };
+
+	return poll(&pfd, 1, timeout) > 0;
+}
+
+/*
+ * Copy the frames of touchpanel_event_list into the ring, waiting for the
+ * consumer while it is full. Returns false if asked to stop meanwhile.
+ */
+static bool
+reader_publish_frames(void)
+{
+	event_list_t *list = &touchpanel_event_list;
+	size_t count = list->input_filled / sizeof(input_event_t);
+	size_t start = 0, i;
+	bool published = false;
+
+	for (i = 0; i < count; i++)
+	{
+		reader_frame_t *frame;
+		size_t numEvents = i + 1 - start;
+
+		if (list->input[i].type != EV_SYN)
+		{
+			continue;
+		}
+
+		frame = spsc_ring_acquire(&sReader.ring);
+
+		if (NULL == frame)
+		{
+			sReader.stalls++;
+
+			/* make sure the consumer knows there is something to drain */
+			if (published)
+			{
+				reader_signal();
+				published = false;
+			}
+
+			while (NULL == (frame = spsc_ring_acquire(&sReader.ring)))
+			{
+				if (reader_wait(READER_STALL_WAIT_MS))
+				{
+					return false;
+				}
+			}
+		}
+
+		frame->hasLatency = latency_queue_pop(&list->latency, &frame->latency);
+
+		frame->numEvents = numEvents;
+		memcpy(frame->events, &list->input[start], numEvents * sizeof(input_event_t));
+		spsc_ring_publish(&sReader.ring);
+
+		published = true;
+		start = i + 1;
+	}
+
+	if (published)
+	{
+		reader_signal();
+	}
+
+	return true;
+}
+
+static void *
+reader_thread(void *arg)
+{
+	struct pollfd fds[2];
+
+	fds[0].fd = sEpollFd;
+	fds[0].events = POLLIN;
+	fds[1].fd = sReader.stopFd;
+	fds[1].events = POLLIN;
+
+	for (;;)
+	{
+		if (poll(fds, 2, -1) < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			nyx_error(MSGID_NYX_MOD_TP_READER, 0, "Touch reader poll failed: %s",
+			          strerror(errno));
+			break;
+		}
+
+		if (fds[1].revents)
+		{
+			break;
+		}
+
+		/* keep going until both the kernel and mtdev are drained */
+		while (read_input_event() > 0)
+		{
+			if (!reader_publish_frames())
+			{
+				return NULL;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static void
+stop_reader_thread(void)
+{
+	uint64_t one = 1;
+
+	if (sReader.running)
+	{
+		if (write(sReader.stopFd, &one, sizeof(one)) < 0)
+		{
+			nyx_error(MSGID_NYX_MOD_TP_READER, 0, "Failed to stop the touch reader: %s",
+			          strerror(errno));
+		}
+
+		pthread_join(sReader.thread, NULL);
+		sReader.running = false;
+
+		if (sReader.stalls)
+		{
+			nyx_info(MSGID_NYX_MOD_TP_READER, 0,
+			         "Touch reader waited %lu times for the consumer", sReader.stalls);
+		}
+	}
+
+	if (sReader.readyFd >= 0)
+	{
+		close(sReader.readyFd);
+	}
+
+	if (sReader.stopFd >= 0)
+	{
+		close(sReader.stopFd);
+	}
+
+	sReader.readyFd = sReader.stopFd = -1;
+	sReader.stalls = 0;
+	spsc_ring_free(&sReader.ring);
+	release_event_list(&sReader.output);
+}
+
+static int
+start_reader_thread(int numSlots)
+{
+	size_t frameSize = sizeof(reader_frame_t) + sEventsPerFrame * sizeof(
+	                       input_event_t);
+
+	if (spsc_ring_init(&sReader.ring, frameSize, READER_RING_FRAMES) < 0 ||
+	        alloc_event_list(&sReader.output, event_list_capacity(), numSlots) < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_OUT_OF_MEMORY, 0, "Out of memory");
+		goto error;
+	}
+
+	sReader.readyFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	sReader.stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (sReader.readyFd < 0 || sReader.stopFd < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_READER, 0, "Failed to create eventfd: %s",
+		          strerror(errno));
+		goto error;
+	}
+
+	if (pthread_create(&sReader.thread, NULL, reader_thread, NULL) != 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_READER, 0, "Failed to start the touch reader");
+		goto error;
+	}
+
+	sReader.running = true;
+	nyx_debug("[touchpanel] reader thread started");
+
+	return 0;
+
+error:
+	stop_reader_thread();
+	return -1;
+}
+
+/* Move published frames into the consumer's list, returns the frame count */
+static int
+reader_take_frames(void)
+{
+	event_list_t *list = &sReader.output;
+	reader_frame_t *frame;
+	size_t filled = 0;
+	bool recording = true;
+	int numFrames = 0;
+
+	latency_queue_reset(&list->latency);
+
+	while (NULL != (frame = spsc_ring_peek(&sReader.ring)) &&
+	        filled + frame->numEvents <= list->capacity)
+	{
+		memcpy(&list->input[filled], frame->events,
+		       frame->numEvents * sizeof(input_event_t));
+		filled += frame->numEvents;
+
+		/* records must stay in step with the frames, stop at the first gap */
+		recording = recording && frame->hasLatency &&
+		            latency_queue_push(&list->latency, &frame->latency);
+
+		spsc_ring_release(&sReader.ring);
+		numFrames++;
 	}
-	else
+
+	list->input_filled = filled * sizeof(input_event_t);
+	list->input_read = 0;
+
+	return numFrames;
+}
+
+static void
+reader_clear_ready(void)
+{
+	uint64_t count;
+
+	if (read(sReader.readyFd, &count, sizeof(count)) < 0 && errno != EAGAIN)
 	{
-		/* Fallback on singletouch handling it no mtdev is present */
-		int ret_val = poll(fds, 1, 0);
+		nyx_error(MSGID_NYX_MOD_TP_READER, 0, "Failed to read touch frame count: %s",
+		          strerror(errno));
+	}
+}
 
-		if (ret_val <= 0)
-		{
-			return 0;
-		}
+/* List touchpanel_get_event() hands frames out from */
+static event_list_t *
+output_event_list(void)
+{
+	return sReader.running ? &sReader.output : &touchpanel_event_list;
+}
 
-		if (fds[0].revents & POLLIN)
-		{
-			rd = read(fds[0].fd, &pEvent, sizeof(input_event_t));
+static void
+refill_event_list(void)
+{
+	event_list_t *list = output_event_list();
 
-			if (rd < 0 && errno != EINTR)
-			{
-				nyx_error(MSGID_NYX_MOD_TP_EVT_READ_ERR, 0, "Failed to read events from keypad event file");
-				return -1;
-			}
-	
-			handle_new_event(&pEvent);
-		}
+	if (!sReader.running)
+	{
+		read_input_event();
+	}
+	else if (0 == reader_take_frames())
+	{
+		/*
+		 * Idle: reset the eventfd before looking again, a frame published in
+		 * between signals it anew.
+		 */
+		reader_clear_ready();
+		reader_take_frames();
+	}
+
+	if (sGeneralSettings.coalesce && list->input_filled)
+	{
+		coalesce_event_list(list);
+	}
+}
+
+static void
+set_gesture_value(multi_finger_gesture_t *gesture, uint16_t code, int32_t value)
+{
+	switch (code)
+	{
+		case GESTURE_STATE:
+			gesture->state = (multi_finger_state_t) value;
+			break;
+
+		case GESTURE_FINGERS:
+			gesture->fingers = value;
+			break;
+
+		case GESTURE_CENTER_X:
+			gesture->centerX = value;
+			break;
+
+		case GESTURE_CENTER_Y:
+			gesture->centerY = value;
+			break;
+
+		case GESTURE_PAN_X:
+			gesture->panX = value;
+			break;
+
+		case GESTURE_PAN_Y:
+			gesture->panY = value;
+			break;
+
+		case GESTURE_SCALE:
+			gesture->scale = value;
+			break;
+
+		case GESTURE_ROTATION:
+			gesture->rotation = value;
+			break;
+
+		default:
+			nyx_error(MSGID_NYX_MOD_TP_ABS_ERR, 0, "Unexpected gesture code 0x%x", code);
+			break;
 	}
-    	
-	return numEvents;
 }
 
 nyx_error_t touchpanel_get_event(nyx_device_t *d, nyx_event_t **e)
 {
 	int event_count = 0;
 	int event_iter = 0;
-	static int read_input = 0;
 
 	nyx_event_t *p_generated = NULL;
 	touchpanel_device_t *touch_device = (touchpanel_device_t *) d;
+	event_list_t *list = output_event_list();
+
+	/*
+	* Event bookkeeping...
+	*/
+	event_count = list->input_filled / sizeof(input_event_t);
+	event_iter = list->input_read / sizeof(input_event_t);
 
 	/*
-	 * Event bookkeeping...
+	 * Once the previous batch is consumed, drain whatever has been queued since
+	 * (by the kernel, inside mtdev or by the reader thread) so the caller can
+	 * keep pulling frames until we are really idle.
 	 */
-	if (!read_input)
+	if (event_iter == event_count)
 	{
-		read_input_event();
-		touch_device->current_event_ptr = NULL;
-		read_input = 1;
-	}
+		refill_event_list();
 
-	/*
-	* Event bookkeeping...
-	*/
-	event_count = touchpanel_event_list.input_filled / sizeof(input_event_t);
-	event_iter = touchpanel_event_list.input_read / sizeof(input_event_t);
+		event_count = list->input_filled / sizeof(input_event_t);
+		event_iter = list->input_read / sizeof(input_event_t);
+	}
 
 	if (event_iter == event_count)
 	{
-		read_input = 0;
+		*e = NULL;
+		return NYX_ERROR_NONE;
 	}
 
 	if (touch_device->current_event_ptr == NULL)
@@ -831,7 +2603,7 @@ nyx_error_t touchpanel_get_event(nyx_device_t *d, nyx_event_t **e)
 		/*
 		* let's allocate new event and hold it here.
 		*/
-		touch_device->current_event_ptr = touch_event_create();
+		touch_device->current_event_ptr = touch_event_create(touch_device);
 	}
 
 	touch_device->current_event_ptr->_parent.type = NYX_EVENT_TOUCHPANEL;
@@ -840,9 +2612,9 @@ nyx_error_t touchpanel_get_event(nyx_device_t *d, nyx_event_t **e)
 	{
 		input_event_t *input_event_ptr;
 		nyx_touchpanel_event_item_t *item_ptr;
-		input_event_ptr = &touchpanel_event_list.input[event_iter];
+		input_event_ptr = &list->input[event_iter];
 
-		touchpanel_event_list.input_read += sizeof(input_event_t);
+		list->input_read += sizeof(input_event_t);
 
 		switch (input_event_ptr->type)
 		{
@@ -853,7 +2625,7 @@ nyx_error_t touchpanel_get_event(nyx_device_t *d, nyx_event_t **e)
 				if (NULL == item_ptr)
 				{
 					p_generated = (nyx_event_t *) touch_device->current_event_ptr;
-					touch_device->current_event_ptr = touch_event_create();
+					touch_device->current_event_ptr = touch_event_create(touch_device);
 					item_ptr = touch_event_get_next_item(
 					               touch_device->current_event_ptr);
 				}
@@ -861,9 +2633,20 @@ nyx_error_t touchpanel_get_event(nyx_device_t *d, nyx_event_t **e)
 				if (NULL != item_ptr)
 				{
 					touch_item_reset(item_ptr);
-					item_ptr->finger = input_event_ptr->value * 1000
-					                   + input_event_ptr->code;
+					item_ptr->finger = input_event_ptr->value * 1000;
 					item_ptr->timestamp = get_ts_tval(&(input_event_ptr->time));
+
+					/* the finger is still down where it was last reported */
+					if (FINGER_UNCHANGED == input_event_ptr->code)
+					{
+						touch_event_pool_entry_t *entry =
+						    (touch_event_pool_entry_t *) touch_device->current_event_ptr;
+						entry->unchanged[entry->event.item_count - 1] = true;
+					}
+					else
+					{
+						item_ptr->finger += input_event_ptr->code;
+					}
 				}
 
 				break;
@@ -882,6 +2665,14 @@ nyx_error_t touchpanel_get_event(nyx_device_t *d, nyx_event_t **e)
 					{
 						item_ptr->y = input_event_ptr->value;
 					}
+					else if (ABS_VELOCITY_X == input_event_ptr->code)
+					{
+						item_ptr->xVelocity = input_event_ptr->value;
+					}
+					else if (ABS_VELOCITY_Y == input_event_ptr->code)
+					{
+						item_ptr->yVelocity = input_event_ptr->value;
+					}
 					else
 					{
 						nyx_error(MSGID_NYX_MOD_TP_ABS_ERR, 0, "Unexpected code 0x%x", input_event_ptr->code);
@@ -911,9 +2702,20 @@ nyx_error_t touchpanel_get_event(nyx_device_t *d, nyx_event_t **e)
 
 				break;
 
+			case EV_GESTURE:
+				if (NULL != touch_device->current_event_ptr)
+				{
+					set_gesture_value(&((touch_event_pool_entry_t *)
+					                    touch_device->current_event_ptr)->gesture,
+					                  input_event_ptr->code, input_event_ptr->value);
+				}
+
+				break;
+
 			case EV_SYN:
 				p_generated = (nyx_event_t *) touch_device->current_event_ptr;
 				touch_device->current_event_ptr = NULL;
+				latency_frame_returned(&list->latency);
 
 				break;
 
@@ -934,24 +2736,276 @@ nyx_error_t touchpanel_get_event(nyx_device_t *d, nyx_event_t **e)
 	return NYX_ERROR_NONE;
 }
 
+/**
+ * Enable or disable collapsing the moves queued for a finger between two
+ * drains to the latest one; downs and ups are always delivered.
+ */
+nyx_error_t touchpanel_set_coalescing(nyx_device_t *d, bool enable)
+{
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	sGeneralSettings.coalesce = enable;
+	return NYX_ERROR_NONE;
+}
+
+/* Number of moves dropped by coalescing so far */
+nyx_error_t touchpanel_get_coalesced(nyx_device_t *d, unsigned long *merged)
+{
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (NULL == merged)
+	{
+		return NYX_ERROR_INVALID_VALUE;
+	}
+
+	*merged = sReadStats.coalesced;
+	return NYX_ERROR_NONE;
+}
+
+/**
+ * Enable or disable delta frames: fingers that neither went down, moved nor
+ * lifted since they were last reported only get an item without position,
+ * see touchpanel_is_contact_unchanged().
+ */
+nyx_error_t touchpanel_set_delta_frames(nyx_device_t *d, bool enable)
+{
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	pthread_mutex_lock(&sSettingsUpdate.lock);
+	sSettingsUpdate.deltaFrames = enable;
+	__atomic_or_fetch(&sSettingsUpdate.changed, SETTINGS_DELTA_FRAMES,
+	                  __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&sSettingsUpdate.lock);
+	return NYX_ERROR_NONE;
+}
+
+/*
+ * Whether an item of a delta frame event is a finger still down but left out
+ * as unchanged; only its finger id is set, the consumer keeps the position it
+ * last reported for it.
+ */
+nyx_error_t touchpanel_is_contact_unchanged(nyx_device_t *d, nyx_event_t *e,
+        int item, bool *unchanged)
+{
+	nyx_event_touchpanel_t *event = (nyx_event_touchpanel_t *) e;
+
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (NULL == e || NULL == unchanged || item < 0 || item >= event->item_count)
+	{
+		return NYX_ERROR_INVALID_VALUE;
+	}
+
+	*unchanged = ((touch_event_pool_entry_t *) e)->unchanged[item];
+	return NYX_ERROR_NONE;
+}
+
+/**
+ * Enable or disable reporting pinch, rotation and pan of the fingers down
+ * with the touch events, see touchpanel_get_gesture().
+ */
+nyx_error_t touchpanel_set_multi_finger_gestures(nyx_device_t *d, bool enable)
+{
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	pthread_mutex_lock(&sSettingsUpdate.lock);
+	sSettingsUpdate.multiFingerGestures = enable;
+	__atomic_or_fetch(&sSettingsUpdate.changed, SETTINGS_MULTI_FINGER,
+	                  __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&sSettingsUpdate.lock);
+	return NYX_ERROR_NONE;
+}
+
+/*
+ * Multi-finger gesture that came with a touch event. Its state is
+ * MULTI_FINGER_NONE when the gesture did not change in that frame.
+ */
+nyx_error_t touchpanel_get_gesture(nyx_device_t *d, nyx_event_t *e,
+                                   multi_finger_gesture_t *gesture)
+{
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (NULL == e || NULL == gesture)
+	{
+		return NYX_ERROR_INVALID_VALUE;
+	}
+
+	*gesture = ((touch_event_pool_entry_t *) e)->gesture;
+	return NYX_ERROR_NONE;
+}
+
+/* Number of finger items left out of delta frames so far */
+nyx_error_t touchpanel_get_suppressed(nyx_device_t *d, unsigned long *suppressed)
+{
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (NULL == suppressed)
+	{
+		return NYX_ERROR_INVALID_VALUE;
+	}
+
+	*suppressed = gesture_state_machine_unchanged();
+	return NYX_ERROR_NONE;
+}
+
+/**
+ * Number of times the kernel dropped touchpanel events (SYN_DROPPED) and the
+ * number of times the device state was successfully read back afterwards.
+ */
+nyx_error_t touchpanel_get_drop_stats(nyx_device_t *d, unsigned long *drops,
+                                      unsigned long *resyncs)
+{
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (drops)
+	{
+		*drops = sReadStats.drops;
+	}
+
+	if (resyncs)
+	{
+		*resyncs = sReadStats.resyncs;
+	}
+
+	return NYX_ERROR_NONE;
+}
+
+/**
+ * Align the resample target of reported positions with the display refresh.
+ * Both values are in ns; the timestamp is of any past refresh and uses the
+ * same clock as the touch event timestamps, CLOCK_MONOTONIC unless the kernel
+ * refused to switch. A period of 0 falls back to the vsyncPeriod setting.
+ */
+nyx_error_t touchpanel_set_vsync(nyx_device_t *d, int64_t timestamp,
+                                 int64_t period)
+{
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (period < 0)
+	{
+		return NYX_ERROR_INVALID_VALUE;
+	}
+
+	pthread_mutex_lock(&sSettingsUpdate.lock);
+	sSettingsUpdate.vsyncTime = timestamp;
+	sSettingsUpdate.vsyncPeriod = period;
+	__atomic_or_fetch(&sSettingsUpdate.changed, SETTINGS_VSYNC, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&sSettingsUpdate.lock);
+	return NYX_ERROR_NONE;
+}
+
+/*
+ * Scan rates are in Hz and need a scanRatePath in the configuration. The
+ * active rate applies while the panel is touched and for idleTimeout ms
+ * after the last contact lifted, the idle rate after that; an idle rate of
+ * 0 disables idle detection.
+ */
 nyx_error_t touchpanel_set_active_scan_rate(nyx_device_t *d, unsigned int r)
 {
-	return NYX_ERROR_NOT_IMPLEMENTED;
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (0 == r)
+	{
+		return NYX_ERROR_INVALID_VALUE;
+	}
+
+	if (NULL == sScanRate.path)
+	{
+		return NYX_ERROR_DEVICE_UNAVAILABLE;
+	}
+
+	return scan_rate_set_active(&sScanRate, r) < 0 ? NYX_ERROR_GENERIC :
+	       NYX_ERROR_NONE;
 }
 
 nyx_error_t touchpanel_set_idle_scan_rate(nyx_device_t *d, unsigned int r)
 {
-	return NYX_ERROR_NOT_IMPLEMENTED;
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (NULL == sScanRate.path)
+	{
+		return NYX_ERROR_DEVICE_UNAVAILABLE;
+	}
+
+	return scan_rate_set_idle(&sScanRate, r) < 0 ? NYX_ERROR_GENERIC :
+	       NYX_ERROR_NONE;
 }
 
 nyx_error_t touchpanel_get_active_scan_rate(nyx_device_t *d, unsigned int *r)
 {
-	return NYX_ERROR_NOT_IMPLEMENTED;
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (NULL == r)
+	{
+		return NYX_ERROR_INVALID_VALUE;
+	}
+
+	if (NULL == sScanRate.path)
+	{
+		return NYX_ERROR_DEVICE_UNAVAILABLE;
+	}
+
+	*r = scan_rate_get_active(&sScanRate);
+
+	return NYX_ERROR_NONE;
 }
 
 nyx_error_t touchpanel_get_idle_scan_rate(nyx_device_t *d, unsigned int *r)
 {
-	return NYX_ERROR_NOT_IMPLEMENTED;
+	if (NULL == d)
+	{
+		return NYX_ERROR_INVALID_HANDLE;
+	}
+
+	if (NULL == r)
+	{
+		return NYX_ERROR_INVALID_VALUE;
+	}
+
+	if (NULL == sScanRate.path)
+	{
+		return NYX_ERROR_DEVICE_UNAVAILABLE;
+	}
+
+	*r = scan_rate_get_idle(&sScanRate);
+
+	return NYX_ERROR_NONE;
 }
 
 nyx_error_t touchpanel_set_mode(nyx_device_t *d, int m)
@@ -0,0 +1,64 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file touchpanel_capture.h
+ *
+ * @brief On-disk format of raw touchpanel captures
+ *
+ * A capture starts with a touchpanel_capture_header_t, followed by numAxes
+ * touchpanel_capture_axis_t records describing the absolute axes of the
+ * device, followed by the raw evdev events as touchpanel_capture_event_t
+ * records until the end of the file. All fields are fixed width and in host
+ * byte order so captures can move between 32 and 64 bit targets.
+ */
+
+#ifndef __TOUCHPANEL_CAPTURE_H
+#define __TOUCHPANEL_CAPTURE_H
+
+#include <stdint.h>
+
+#define TOUCHPANEL_CAPTURE_MAGIC    0x4E595854  /* "TXYN" */
+#define TOUCHPANEL_CAPTURE_VERSION  1
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t numAxes;       /**< axis records following the header */
+	uint32_t reserved;
+} touchpanel_capture_header_t;
+
+typedef struct
+{
+	uint32_t code;          /**< ABS_* code of the axis */
+	int32_t minimum;
+	int32_t maximum;
+	int32_t fuzz;
+	int32_t flat;
+	int32_t resolution;
+} touchpanel_capture_axis_t;
+
+typedef struct
+{
+	int64_t sec;            /**< kernel timestamp of the event */
+	int64_t usec;
+	uint16_t type;
+	uint16_t code;
+	int32_t value;
+} touchpanel_capture_event_t;
+
+#endif  /* __TOUCHPANEL_CAPTURE_H */
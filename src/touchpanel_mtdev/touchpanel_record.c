@@ -0,0 +1,225 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file touchpanel_record.c
+ *
+ * @brief Record raw evdev frames of a touchpanel into a capture file
+ *
+ * Usage: touchpanel-record [-d device] [-f frames] capture-file
+ *
+ * Recording stops after the requested number of SYN_REPORT frames or when
+ * interrupted, and always ends on a frame boundary.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/input.h>
+#include <sys/ioctl.h>
+
+#include "touchpanel_capture.h"
+
+#define DEFAULT_DEVICE      "/dev/input/touchscreen0"
+#define READ_EVENTS         64
+
+static const uint32_t capture_axes[] =
+{
+	ABS_X, ABS_Y, ABS_MT_SLOT, ABS_MT_TOUCH_MAJOR, ABS_MT_TOUCH_MINOR,
+	ABS_MT_WIDTH_MAJOR, ABS_MT_WIDTH_MINOR, ABS_MT_ORIENTATION,
+	ABS_MT_POSITION_X, ABS_MT_POSITION_Y, ABS_MT_TRACKING_ID, ABS_MT_PRESSURE,
+};
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int sig)
+{
+	stop_requested = 1;
+}
+
+static int write_header(int fd, FILE *out)
+{
+	touchpanel_capture_header_t header;
+	touchpanel_capture_axis_t axes[sizeof(capture_axes) / sizeof(capture_axes[0])];
+	unsigned int i, n = 0;
+
+	for (i = 0; i < sizeof(capture_axes) / sizeof(capture_axes[0]); i++)
+	{
+		struct input_absinfo abs;
+
+		if (ioctl(fd, EVIOCGABS(capture_axes[i]), &abs) < 0)
+		{
+			continue;
+		}
+
+		axes[n].code = capture_axes[i];
+		axes[n].minimum = abs.minimum;
+		axes[n].maximum = abs.maximum;
+		axes[n].fuzz = abs.fuzz;
+		axes[n].flat = abs.flat;
+		axes[n].resolution = abs.resolution;
+		n++;
+	}
+
+	header.magic = TOUCHPANEL_CAPTURE_MAGIC;
+	header.version = TOUCHPANEL_CAPTURE_VERSION;
+	header.numAxes = n;
+	header.reserved = 0;
+
+	if (fwrite(&header, sizeof(header), 1, out) != 1 ||
+	        fwrite(axes, sizeof(axes[0]), n, out) != n)
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const char *device = DEFAULT_DEVICE;
+	unsigned long maxFrames = 0, frames = 0, events = 0;
+	struct input_event raw[READ_EVENTS];
+	struct sigaction sa;
+	FILE *out;
+	int fd, opt, ret = 1;
+	int clockId = CLOCK_MONOTONIC;
+
+	while ((opt = getopt(argc, argv, "d:f:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'd':
+				device = optarg;
+				break;
+
+			case 'f':
+				maxFrames = strtoul(optarg, NULL, 10);
+				break;
+
+			default:
+				fprintf(stderr, "Usage: %s [-d device] [-f frames] capture-file\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if (optind >= argc)
+	{
+		fprintf(stderr, "Usage: %s [-d device] [-f frames] capture-file\n", argv[0]);
+		return 1;
+	}
+
+	fd = open(device, O_RDONLY);
+
+	if (fd < 0)
+	{
+		fprintf(stderr, "Could not open %s: %s\n", device, strerror(errno));
+		return 1;
+	}
+
+	/* same timestamps as the module sees, which switches to CLOCK_MONOTONIC too */
+	if (ioctl(fd, EVIOCSCLOCKID, &clockId) < 0)
+	{
+		fprintf(stderr, "Warning: timestamps stay on CLOCK_REALTIME: %s\n",
+		        strerror(errno));
+	}
+
+	out = fopen(argv[optind], "wb");
+
+	if (NULL == out)
+	{
+		fprintf(stderr, "Could not create %s: %s\n", argv[optind], strerror(errno));
+		close(fd);
+		return 1;
+	}
+
+	if (write_header(fd, out) < 0)
+	{
+		fprintf(stderr, "Failed to write capture header\n");
+		goto exit;
+	}
+
+	/* no SA_RESTART, a signal has to interrupt the blocking read() */
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = on_signal;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	while (!stop_requested && (maxFrames == 0 || frames < maxFrames))
+	{
+		ssize_t rd = read(fd, raw, sizeof(raw));
+		int i, n;
+
+		if (rd < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			fprintf(stderr, "Failed to read events: %s\n", strerror(errno));
+			goto exit;
+		}
+
+		n = rd / sizeof(struct input_event);
+
+		for (i = 0; i < n; i++)
+		{
+			touchpanel_capture_event_t ev;
+
+			ev.sec = raw[i].time.tv_sec;
+			ev.usec = raw[i].time.tv_usec;
+			ev.type = raw[i].type;
+			ev.code = raw[i].code;
+			ev.value = raw[i].value;
+
+			if (fwrite(&ev, sizeof(ev), 1, out) != 1)
+			{
+				fprintf(stderr, "Failed to write capture\n");
+				goto exit;
+			}
+
+			events++;
+
+			if (ev.type == EV_SYN && ev.code == SYN_REPORT)
+			{
+				frames++;
+
+				if (stop_requested || (maxFrames && frames == maxFrames))
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	printf("recorded %lu events in %lu frames from %s\n", events, frames, device);
+	ret = 0;
+
+exit:
+	if (fclose(out) != 0)
+	{
+		ret = 1;
+	}
+
+	close(fd);
+	return ret;
+}
@@ -0,0 +1,396 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file touchpanel_replay.c
+ *
+ * @brief Replay a touchpanel capture through the module's event pipeline
+ *
+ * Usage: touchpanel-replay [-r] [-v] [-n loops] [-W width] [-H height]
+ *                          [-R offset] capture-file
+ *
+ * The raw events of a capture recorded with touchpanel-record are fed to the
+ * same handlers the module uses for live input, without any device node.
+ * By default frames are replayed as fast as possible; -r keeps the original
+ * inter-frame timing. Per-frame processing cost is measured in thread CPU time
+ * and reported as p50/p99/max together with the overall frame rate, so the
+ * numbers can be compared before and after a change to the pipeline. -v dumps
+ * the generated nyx events for diffing. Settings come from the module.touchpanel
+ * group of /etc/nyx.conf like on the device; -R enables resampling with the
+ * given target offset in us.
+ */
+
+#include "touchpanel.c"
+#include "touchpanel_capture.h"
+#include "latency_histogram.h"
+
+#define DEFAULT_DISPLAY_WIDTH   1024
+#define DEFAULT_DISPLAY_HEIGHT  768
+
+typedef struct
+{
+	touchpanel_capture_header_t header;
+	touchpanel_capture_axis_t *axes;
+	touchpanel_capture_event_t *events;
+	size_t numEvents;
+} touchpanel_capture_t;
+
+static int load_capture(const char *path, touchpanel_capture_t *capture)
+{
+	FILE *in = fopen(path, "rb");
+	long start, size;
+
+	if (NULL == in)
+	{
+		fprintf(stderr, "Could not open %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	if (fread(&capture->header, sizeof(capture->header), 1, in) != 1 ||
+	        capture->header.magic != TOUCHPANEL_CAPTURE_MAGIC ||
+	        capture->header.version != TOUCHPANEL_CAPTURE_VERSION)
+	{
+		fprintf(stderr, "%s is not a touchpanel capture\n", path);
+		goto error;
+	}
+
+	capture->axes = calloc(capture->header.numAxes + 1, sizeof(capture->axes[0]));
+
+	if (NULL == capture->axes ||
+	        fread(capture->axes, sizeof(capture->axes[0]), capture->header.numAxes,
+	              in) != capture->header.numAxes)
+	{
+		fprintf(stderr, "Truncated capture header in %s\n", path);
+		goto error;
+	}
+
+	/* the event stream runs until the end of the file, load it all upfront */
+	start = ftell(in);
+	fseek(in, 0, SEEK_END);
+	size = ftell(in) - start;
+	fseek(in, start, SEEK_SET);
+
+	capture->numEvents = size / sizeof(touchpanel_capture_event_t);
+	capture->events = malloc(capture->numEvents * sizeof(touchpanel_capture_event_t)
+	                         + 1);
+
+	if (NULL == capture->events ||
+	        fread(capture->events, sizeof(touchpanel_capture_event_t),
+	              capture->numEvents, in) != capture->numEvents)
+	{
+		fprintf(stderr, "Failed to read events from %s\n", path);
+		goto error;
+	}
+
+	fclose(in);
+	return 0;
+
+error:
+	free(capture->axes);
+	fclose(in);
+	return -1;
+}
+
+static const touchpanel_capture_axis_t *find_axis(const touchpanel_capture_t
+        *capture, uint32_t code)
+{
+	uint32_t i;
+
+	for (i = 0; i < capture->header.numAxes; i++)
+	{
+		if (capture->axes[i].code == code)
+		{
+			return &capture->axes[i];
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Mirror init_touchpanel() using the axes stored in the capture instead of
+ * the device node and framebuffer; the capture is replayed as input 0.
+ */
+static int init_replay(const touchpanel_capture_t *capture, int width,
+                       int height, bool *multitouch)
+{
+	const touchpanel_capture_axis_t *axisX, *axisY;
+	touch_input_t *input = &sInputs[0];
+	int numSlots = DEFAULT_MT_SLOTS;
+
+	memset(input, 0, sizeof(*input));
+	input->fd = -1;
+	sNumInputs = 1;
+
+	*multitouch = find_axis(capture, ABS_MT_SLOT) != NULL;
+
+	axisX = find_axis(capture, *multitouch ? ABS_MT_POSITION_X : ABS_X);
+	axisY = find_axis(capture, *multitouch ? ABS_MT_POSITION_Y : ABS_Y);
+
+	if (NULL == axisX || NULL == axisY || axisX->maximum <= 0 ||
+	        axisY->maximum <= 0)
+	{
+		fprintf(stderr, "Capture does not describe the position axes\n");
+		return -1;
+	}
+
+	if (!*multitouch && find_axis(capture, ABS_MT_POSITION_X))
+	{
+		fprintf(stderr, "Type A multitouch captures are not supported\n");
+		return -1;
+	}
+
+	if (init_coord_transform(input, axisX->maximum, axisY->maximum, width,
+	                         height) < 0)
+	{
+		fprintf(stderr, "Capture axes cannot be mapped to %dx%d\n", width, height);
+		return -1;
+	}
+
+	if (*multitouch)
+	{
+		const touchpanel_capture_axis_t *slots = find_axis(capture, ABS_MT_SLOT);
+
+		numSlots = slots->maximum + 1;
+
+		if (numSlots < 1 || numSlots > MAX_MT_SLOTS)
+		{
+			fprintf(stderr, "Capture reports %d slots\n", numSlots);
+			return -1;
+		}
+
+		if (init_mt_slots(&input->slots, numSlots) < 0)
+		{
+			return -1;
+		}
+	}
+
+	if (init_event_list(numSlots) < 0)
+	{
+		return -1;
+	}
+
+	init_gesture_state_machine(&sGeneralSettings, numSlots);
+
+	return 0;
+}
+
+static void dump_frame(unsigned long frame)
+{
+	size_t i, count = touchpanel_event_list.input_filled / sizeof(input_event_t);
+
+	for (i = 0; i < count; i++)
+	{
+		input_event_t *ev = &touchpanel_event_list.input[i];
+
+		printf("%lu %u %u %d\n", frame, ev->type, ev->code, ev->value);
+	}
+}
+
+static int64_t thread_cpu_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void wait_until(int64_t deadline)
+{
+	struct timespec ts;
+
+	ts.tv_sec = deadline / 1000000000LL;
+	ts.tv_nsec = deadline % 1000000000LL;
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+		;
+}
+
+int main(int argc, char **argv)
+{
+	touchpanel_capture_t capture;
+	latency_histogram_t *frameCost;
+	int width = DEFAULT_DISPLAY_WIDTH, height = DEFAULT_DISPLAY_HEIGHT;
+	unsigned long loops = 1, loop, frames = 0, events = 0;
+	bool realtime = false, verbose = false, multitouch;
+	int64_t wallStart, wallEnd, frameStart = -1, loopShift = 0;
+	struct timespec ts;
+	int opt;
+
+	load_touchpanel_settings(&sGeneralSettings);
+
+	while ((opt = getopt(argc, argv, "rvn:W:H:R:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'r':
+				realtime = true;
+				break;
+
+			case 'v':
+				verbose = true;
+				break;
+
+			case 'n':
+				loops = strtoul(optarg, NULL, 10);
+				break;
+
+			case 'W':
+				width = atoi(optarg);
+				break;
+
+			case 'H':
+				height = atoi(optarg);
+				break;
+
+			case 'R':
+				sGeneralSettings.resample = true;
+				sGeneralSettings.resampleOffset = atoi(optarg);
+				break;
+
+			default:
+				goto usage;
+		}
+	}
+
+	if (optind >= argc || loops == 0 || width <= 0 || height <= 0)
+	{
+		goto usage;
+	}
+
+	if (load_capture(argv[optind], &capture) < 0 ||
+	        init_replay(&capture, width, height, &multitouch) < 0)
+	{
+		return 1;
+	}
+
+	frameCost = calloc(1, sizeof(*frameCost));
+
+	if (NULL == frameCost)
+	{
+		return 1;
+	}
+
+	/*
+	 * The pipeline runs on the recorded kernel timestamps; keep them moving
+	 * forward across loops, one second apart.
+	 */
+	if (capture.numEvents)
+	{
+		const touchpanel_capture_event_t *first = &capture.events[0];
+		const touchpanel_capture_event_t *last = &capture.events[capture.numEvents - 1];
+
+		loopShift = (last->sec - first->sec) * 1000000LL + last->usec - first->usec +
+		            1000000LL;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	wallStart = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+
+	for (loop = 0; loop < loops; loop++)
+	{
+		int64_t captureStart = 0, replayStart = 0;
+		size_t i;
+
+		for (i = 0; i < capture.numEvents; i++)
+		{
+			const touchpanel_capture_event_t *rec = &capture.events[i];
+			input_event_t event;
+
+			int64_t usec = rec->sec * 1000000LL + rec->usec + loop * loopShift;
+
+			event.time.tv_sec = usec / 1000000;
+			event.time.tv_usec = usec % 1000000;
+			event.type = rec->type;
+			event.code = rec->code;
+			event.value = rec->value;
+
+			if (frameStart < 0)
+			{
+				if (realtime)
+				{
+					int64_t t = rec->sec * 1000000000LL + rec->usec * 1000LL;
+
+					clock_gettime(CLOCK_MONOTONIC, &ts);
+
+					if (i == 0)
+					{
+						captureStart = t;
+						replayStart = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+					}
+					else
+					{
+						wait_until(replayStart + (t - captureStart));
+					}
+				}
+
+				frameStart = thread_cpu_now();
+			}
+
+			if (multitouch)
+			{
+				handle_new_mt_event(&sInputs[0], &event);
+			}
+			else
+			{
+				handle_new_event(&sInputs[0], &event);
+			}
+
+			events++;
+
+			if (event.type == EV_SYN && event.code == SYN_REPORT)
+			{
+				latency_histogram_record(frameCost, thread_cpu_now() - frameStart);
+				frameStart = -1;
+
+				if (verbose)
+				{
+					dump_frame(frames);
+				}
+
+				frames++;
+				touchpanel_event_list.input_filled = 0;
+				touchpanel_event_list.input_read = 0;
+			}
+		}
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	wallEnd = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+
+	double seconds = (wallEnd - wallStart) / 1e9;
+
+	fprintf(stderr, "replayed %lu frames (%lu events) in %.3f s: %.0f frames/s\n",
+	        frames, events, seconds, seconds > 0 ? frames / seconds : 0.0);
+	fprintf(stderr, "cpu per frame: p50 %.2f us, p99 %.2f us, max %.2f us\n",
+	        latency_histogram_percentile(frameCost, 50) / 1000.0,
+	        latency_histogram_percentile(frameCost, 99) / 1000.0,
+	        latency_histogram_max(frameCost) / 1000.0);
+
+	deinit_gesture_state_machine();
+	free_mt_slots(&sInputs[0].slots);
+	free_event_list();
+	free(frameCost);
+	free(capture.events);
+	free(capture.axes);
+	return 0;
+
+usage:
+	fprintf(stderr,
+	        "Usage: %s [-r] [-v] [-n loops] [-W width] [-H height] [-R offset] capture-file\n",
+	        argv[0]);
+	return 1;
+}
@@ -0,0 +1,386 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file touchpanel_scanrate.c
+ *
+ * @brief Drop the controller to its idle scan rate while nobody touches it
+ *
+ * The input path reports the number of contacts of every frame. When the
+ * last one lifts, a deadline idleTimeout ms away is armed; a helper thread
+ * sleeping on it writes the idle rate to the sysfs attribute once it
+ * passes. The first contact disarms it and, if the controller already went
+ * idle, wakes the thread to restore the active rate, so the input path never
+ * waits for sysfs. Only transitions take the lock, frames with an unchanged
+ * touch state return after a single comparison. Without a known active rate
+ * to come back to, the controller is never put to idle.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <nyx/module/nyx_log.h>
+
+#include "touchpanel_scanrate.h"
+#include "msgid.h"
+
+#define NSEC_PER_SEC    1000000000L
+
+static int
+write_rate(const scan_rate_t *pScanRate, unsigned int rate)
+{
+	char value[16];
+	int fd, len, ret = 0;
+
+	fd = open(pScanRate->path, O_WRONLY);
+
+	if (fd < 0)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_SCAN_RATE, 0, "Cannot open %s: %s", pScanRate->path,
+		          strerror(errno));
+		return -1;
+	}
+
+	len = snprintf(value, sizeof(value), "%u\n", rate);
+
+	if (write(fd, value, len) != len)
+	{
+		nyx_error(MSGID_NYX_MOD_TP_SCAN_RATE, 0, "Cannot set scan rate %u Hz: %s", rate,
+		          strerror(errno));
+		ret = -1;
+	}
+
+	close(fd);
+	return ret;
+}
+
+static unsigned int
+read_rate(const char *path)
+{
+	char value[16];
+	ssize_t len;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0)
+	{
+		return 0;
+	}
+
+	len = read(fd, value, sizeof(value) - 1);
+	close(fd);
+
+	if (len <= 0)
+	{
+		return 0;
+	}
+
+	value[len] = '\0';
+	return strtoul(value, NULL, 10);
+}
+
+static bool
+deadline_passed(const struct timespec *deadline)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec > deadline->tv_sec || (now.tv_sec == deadline->tv_sec &&
+	        now.tv_nsec >= deadline->tv_nsec);
+}
+
+/* Called with the lock held */
+static void
+arm_idle_deadline(scan_rate_t *pScanRate)
+{
+	if (0 == pScanRate->idleRate || pScanRate->idleTimeout <= 0)
+	{
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &pScanRate->deadline);
+	pScanRate->deadline.tv_sec += pScanRate->idleTimeout / 1000;
+	pScanRate->deadline.tv_nsec += (pScanRate->idleTimeout % 1000) * 1000000L;
+
+	if (pScanRate->deadline.tv_nsec >= NSEC_PER_SEC)
+	{
+		pScanRate->deadline.tv_sec++;
+		pScanRate->deadline.tv_nsec -= NSEC_PER_SEC;
+	}
+
+	pScanRate->deadlineSet = true;
+	pthread_cond_signal(&pScanRate->cond);
+}
+
+static void *
+idle_thread(void *arg)
+{
+	scan_rate_t *pScanRate = arg;
+
+	pthread_mutex_lock(&pScanRate->lock);
+
+	while (!pScanRate->stop)
+	{
+		/* the sysfs write is done here rather than on the input path */
+		if (pScanRate->wake)
+		{
+			pScanRate->wake = false;
+
+			if (pScanRate->idle &&
+			        write_rate(pScanRate, pScanRate->activeRate) == 0)
+			{
+				pScanRate->idle = false;
+				nyx_debug("[touchpanel] active, scanning at %u Hz", pScanRate->activeRate);
+			}
+
+			continue;
+		}
+
+		if (!pScanRate->deadlineSet)
+		{
+			pthread_cond_wait(&pScanRate->cond, &pScanRate->lock);
+			continue;
+		}
+
+		if (!deadline_passed(&pScanRate->deadline))
+		{
+			pthread_cond_timedwait(&pScanRate->cond, &pScanRate->lock,
+			                       &pScanRate->deadline);
+			continue;
+		}
+
+		pScanRate->deadlineSet = false;
+
+		/* never idle without a rate to come back to */
+		if (!pScanRate->touching && !pScanRate->idle && pScanRate->activeRate &&
+		        write_rate(pScanRate, pScanRate->idleRate) == 0)
+		{
+			pScanRate->idle = true;
+			pScanRate->idleEntries++;
+			nyx_debug("[touchpanel] idle, scanning at %u Hz", pScanRate->idleRate);
+		}
+	}
+
+	pthread_mutex_unlock(&pScanRate->lock);
+
+	return NULL;
+}
+
+/*
+ * Take over scan rate control through the given attribute. An activeRate of
+ * 0 keeps the rate the controller currently runs at. Returns 0 without doing
+ * anything when path is NULL or the idle settings are disabled.
+ */
+int
+scan_rate_init(scan_rate_t *pScanRate, const char *path,
+               unsigned int activeRate,
+               const interrupt_on_touch_settings_t *pIdleSettings)
+{
+	pthread_condattr_t attr;
+
+	memset(pScanRate, 0, sizeof(*pScanRate));
+
+	if (NULL == path || !pIdleSettings->enabled)
+	{
+		return 0;
+	}
+
+	pScanRate->path = strdup(path);
+
+	if (NULL == pScanRate->path)
+	{
+		return -1;
+	}
+
+	pScanRate->activeRate = activeRate ? activeRate : read_rate(path);
+
+	if (0 == pScanRate->activeRate)
+	{
+		nyx_warn(MSGID_NYX_MOD_TP_SCAN_RATE, 0,
+		         "Cannot read the scan rate from %s, not going idle", path);
+		goto error;
+	}
+
+	pScanRate->idleRate = pIdleSettings->scanRate > 0 ? pIdleSettings->scanRate : 0;
+	pScanRate->idleTimeout = pIdleSettings->noTouchThreshold;
+
+	if (activeRate && write_rate(pScanRate, activeRate) < 0)
+	{
+		goto error;
+	}
+
+	pthread_mutex_init(&pScanRate->lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&pScanRate->cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	if (pthread_create(&pScanRate->thread, NULL, idle_thread, pScanRate) != 0)
+	{
+		pthread_cond_destroy(&pScanRate->cond);
+		pthread_mutex_destroy(&pScanRate->lock);
+		goto error;
+	}
+
+	/* nobody touches the panel yet */
+	pthread_mutex_lock(&pScanRate->lock);
+	arm_idle_deadline(pScanRate);
+	pthread_mutex_unlock(&pScanRate->lock);
+
+	nyx_debug("[touchpanel] scan rate %u Hz, %u Hz after %d ms idle",
+	          pScanRate->activeRate, pScanRate->idleRate, pScanRate->idleTimeout);
+
+	return 0;
+
+error:
+	free(pScanRate->path);
+	pScanRate->path = NULL;
+	return -1;
+}
+
+/* Stop the idle detection and leave the controller at its active rate */
+void
+scan_rate_deinit(scan_rate_t *pScanRate)
+{
+	if (NULL == pScanRate->path)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&pScanRate->lock);
+	pScanRate->stop = true;
+	pthread_cond_signal(&pScanRate->cond);
+	pthread_mutex_unlock(&pScanRate->lock);
+
+	pthread_join(pScanRate->thread, NULL);
+
+	if (pScanRate->idle && pScanRate->activeRate)
+	{
+		write_rate(pScanRate, pScanRate->activeRate);
+	}
+
+	if (pScanRate->idleEntries)
+	{
+		nyx_info(MSGID_NYX_MOD_TP_SCAN_RATE, 0, "Touch controller went idle %lu times",
+		         pScanRate->idleEntries);
+	}
+
+	pthread_cond_destroy(&pScanRate->cond);
+	pthread_mutex_destroy(&pScanRate->lock);
+	free(pScanRate->path);
+	pScanRate->path = NULL;
+}
+
+void
+scan_rate_contacts(scan_rate_t *pScanRate, int numContacts)
+{
+	bool touching = numContacts > 0;
+
+	if (NULL == pScanRate->path || touching == pScanRate->touching)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&pScanRate->lock);
+	pScanRate->touching = touching;
+
+	if (touching)
+	{
+		pScanRate->deadlineSet = false;
+
+		/* the idle thread ramps the controller back up */
+		if (pScanRate->idle)
+		{
+			pScanRate->wake = true;
+			pthread_cond_signal(&pScanRate->cond);
+		}
+	}
+	else
+	{
+		arm_idle_deadline(pScanRate);
+	}
+
+	pthread_mutex_unlock(&pScanRate->lock);
+}
+
+int
+scan_rate_set_active(scan_rate_t *pScanRate, unsigned int rate)
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&pScanRate->lock);
+	pScanRate->activeRate = rate;
+
+	if (!pScanRate->idle)
+	{
+		ret = write_rate(pScanRate, rate);
+	}
+
+	pthread_mutex_unlock(&pScanRate->lock);
+
+	return ret;
+}
+
+int
+scan_rate_set_idle(scan_rate_t *pScanRate, unsigned int rate)
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&pScanRate->lock);
+	pScanRate->idleRate = rate;
+
+	if (pScanRate->idle)
+	{
+		ret = write_rate(pScanRate, rate);
+	}
+	else if (!pScanRate->touching && !pScanRate->deadlineSet)
+	{
+		/* idle detection may just have been enabled */
+		arm_idle_deadline(pScanRate);
+	}
+
+	pthread_mutex_unlock(&pScanRate->lock);
+
+	return ret;
+}
+
+unsigned int
+scan_rate_get_active(scan_rate_t *pScanRate)
+{
+	unsigned int rate;
+
+	pthread_mutex_lock(&pScanRate->lock);
+	rate = pScanRate->activeRate;
+	pthread_mutex_unlock(&pScanRate->lock);
+
+	return rate;
+}
+
+unsigned int
+scan_rate_get_idle(scan_rate_t *pScanRate)
+{
+	unsigned int rate;
+
+	pthread_mutex_lock(&pScanRate->lock);
+	rate = pScanRate->idleRate;
+	pthread_mutex_unlock(&pScanRate->lock);
+
+	return rate;
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __TOUCHPANEL_SCANRATE_H
+#define __TOUCHPANEL_SCANRATE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "touchpanel_gestures.h"
+
+typedef struct scan_rate
+{
+	char *path;                 /**< sysfs attribute taking the scan rate in Hz,
+                                     NULL when scan rate control is off */
+	unsigned int activeRate;
+	unsigned int idleRate;
+	int idleTimeout;            /**< ms without contacts before going idle */
+	bool touching;              /**< written by the input path only */
+	bool idle;
+	bool deadlineSet;
+	bool wake;                  /**< touched while idle, restore activeRate */
+	bool stop;
+	struct timespec deadline;   /**< CLOCK_MONOTONIC, when to go idle */
+	unsigned long idleEntries;
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+} scan_rate_t;
+
+int scan_rate_init(scan_rate_t *pScanRate, const char *path,
+                   unsigned int activeRate,
+                   const interrupt_on_touch_settings_t *pIdleSettings);
+void scan_rate_deinit(scan_rate_t *pScanRate);
+void scan_rate_contacts(scan_rate_t *pScanRate, int numContacts);
+int scan_rate_set_active(scan_rate_t *pScanRate, unsigned int rate);
+int scan_rate_set_idle(scan_rate_t *pScanRate, unsigned int rate);
+unsigned int scan_rate_get_active(scan_rate_t *pScanRate);
+unsigned int scan_rate_get_idle(scan_rate_t *pScanRate);
+
+#endif  /* __TOUCHPANEL_SCANRATE_H */
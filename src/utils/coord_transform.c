@@ -0,0 +1,78 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+* @file coord_transform.c
+*
+* @brief Q16 affine coordinate transform set-up
+*
+*/
+
+#include <math.h>
+#include <stddef.h>
+
+#include "coord_transform.h"
+
+const double coord_transform_identity[6] = { 1, 0, 0, 0, 1, 0 };
+
+/* keeps products with 16 bit coordinates well within 64 bits */
+#define MAX_FACTOR  ((double)INT32_MAX)
+
+static int to_q16(double value, int64_t *pFactor)
+{
+	value = round(value * (1 << COORD_TRANSFORM_SHIFT));
+
+	if (!isfinite(value) || fabs(value) > MAX_FACTOR)
+	{
+		return -1;
+	}
+
+	*pFactor = (int64_t) value;
+	return 0;
+}
+
+int coord_transform_init(coord_transform_t *t, int maxX, int maxY, int xres,
+                         int yres, const double matrix[6])
+{
+	coord_transform_t q;
+
+	if (maxX <= 0 || maxY <= 0)
+	{
+		return -1;
+	}
+
+	if (NULL == matrix)
+	{
+		matrix = coord_transform_identity;
+	}
+
+	/* normalize the device axes, apply the matrix, scale to the display */
+	if (to_q16(matrix[0] * xres / maxX, &q.xx) < 0 ||
+	        to_q16(matrix[1] * xres / maxY, &q.xy) < 0 ||
+	        to_q16(matrix[2] * xres, &q.x0) < 0 ||
+	        to_q16(matrix[3] * yres / maxX, &q.yx) < 0 ||
+	        to_q16(matrix[4] * yres / maxY, &q.yy) < 0 ||
+	        to_q16(matrix[5] * yres, &q.y0) < 0)
+	{
+		return -1;
+	}
+
+	/* round to the nearest pixel rather than truncate */
+	q.x0 += 1 << (COORD_TRANSFORM_SHIFT - 1);
+	q.y0 += 1 << (COORD_TRANSFORM_SHIFT - 1);
+	*t = q;
+	return 0;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file coord_transform.h
+ *
+ * @brief Fixed-point affine transform from device to display coordinates
+ *
+ * The calibration is a 2x3 matrix in normalized coordinates, where 0..1
+ * spans each axis, as used by libinput and X11 (e.g. "0;-1;1;1;0;0" rotates
+ * by 90 degrees). coord_transform_init() folds it together with the device
+ * to display scaling into Q16 factors once, so each touch point costs a
+ * single inline, branch-free evaluation with integer multiplies.
+ */
+
+#ifndef COORD_TRANSFORM_H_
+#define COORD_TRANSFORM_H_
+
+#include <stdint.h>
+
+#define COORD_TRANSFORM_SHIFT   16
+
+typedef struct coord_transform
+{
+	int64_t xx, xy, x0;     /**< Q16 factors of the display X */
+	int64_t yx, yy, y0;     /**< Q16 factors of the display Y */
+} coord_transform_t;
+
+extern const double coord_transform_identity[6];
+
+/*
+ * Device axes span 0..maxX and 0..maxY, the display xres by yres pixels;
+ * matrix is { a, b, c, d, e, f } with x' = a*x + b*y + c, y' = d*x + e*y + f
+ * in normalized coordinates. Returns -1, leaving the transform untouched, if
+ * an axis is empty or a factor does not fit.
+ */
+int coord_transform_init(coord_transform_t *t, int maxX, int maxY, int xres,
+                         int yres, const double matrix[6]);
+
+static inline void coord_transform_apply(const coord_transform_t *t, int x,
+        int y, int *pX, int *pY)
+{
+	*pX = (int)((t->xx * x + t->xy * y + t->x0) >> COORD_TRANSFORM_SHIFT);
+	*pY = (int)((t->yx * x + t->yy * y + t->y0) >> COORD_TRANSFORM_SHIFT);
+}
+
+#endif // COORD_TRANSFORM_H_
@@ -0,0 +1,102 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+* @file evdev_mask.c
+*
+* @brief Kernel side filtering of evdev events
+*
+*/
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+
+#include "evdev_mask.h"
+
+#define BITS_PER_LONG       (8 * sizeof(unsigned long))
+#define MASK_LONGS(bits)    (((bits) + BITS_PER_LONG - 1) / BITS_PER_LONG)
+
+static void
+mask_set_bit(unsigned long *mask, unsigned int bit)
+{
+	mask[bit / BITS_PER_LONG] |= 1UL << (bit % BITS_PER_LONG);
+}
+
+/* type 0 masks the event types, any other type the codes of that type */
+static int
+set_mask(int fd, unsigned int type, const unsigned long *mask, size_t size)
+{
+#ifdef EVIOCSMASK
+	struct input_mask inputMask;
+
+	inputMask.type = type;
+	inputMask.codes_size = size;
+	inputMask.codes_ptr = (uintptr_t) mask;
+
+	return ioctl(fd, EVIOCSMASK, &inputMask);
+#else
+	errno = ENOTTY;
+	return -1;
+#endif
+}
+
+int
+evdev_set_filter(int fd, const evdev_filter_t *filters, int numFilters)
+{
+	/* KEY_CNT is the largest code space of all event types */
+	unsigned long types[MASK_LONGS(EV_CNT)];
+	unsigned long codes[MASK_LONGS(KEY_CNT)];
+	int i, j;
+
+	memset(types, 0, sizeof(types));
+
+	/* narrow the codes first, the types mask opens nothing up then */
+	for (i = 0; i < numFilters; i++)
+	{
+		if (filters[i].type == EV_SYN || filters[i].type >= EV_CNT)
+		{
+			errno = EINVAL;
+			return -1;
+		}
+
+		mask_set_bit(types, filters[i].type);
+
+		if (filters[i].codes == NULL)
+		{
+			continue;
+		}
+
+		memset(codes, 0, sizeof(codes));
+
+		for (j = 0; j < filters[i].numCodes; j++)
+		{
+			if (filters[i].codes[j] < KEY_CNT)
+			{
+				mask_set_bit(codes, filters[i].codes[j]);
+			}
+		}
+
+		if (set_mask(fd, filters[i].type, codes, sizeof(codes)) < 0)
+		{
+			return -1;
+		}
+	}
+
+	return set_mask(fd, 0, types, sizeof(types));
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file evdev_mask.h
+ *
+ * @brief Kernel side filtering of evdev events
+ *
+ * EVIOCSMASK has evdev drop the events a client has no use for before they
+ * are queued, so they cost neither wakeups nor reads. The mask applies to
+ * the file descriptor it is set on only; EV_SYN is never filtered and the
+ * EVIOCG* state queries are not affected. Kernels before 4.4 do not know the
+ * ioctl, the caller then has to keep filtering the events itself.
+ */
+
+#ifndef EVDEV_MASK_H_
+#define EVDEV_MASK_H_
+
+typedef struct evdev_filter
+{
+	unsigned int type;          /**< event type let through, EV_KEY, EV_ABS, ... */
+	const unsigned int *codes;  /**< codes of the type let through, NULL for all */
+	int numCodes;
+} evdev_filter_t;
+
+/*
+ * Let only the events described by filters through on fd, any type not
+ * listed is dropped. Returns 0 or -1 with errno set, in which case the
+ * device may be left partly filtered, never more than asked for.
+ */
+int evdev_set_filter(int fd, const evdev_filter_t *filters, int numFilters);
+
+#endif /* EVDEV_MASK_H_ */
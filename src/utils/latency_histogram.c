@@ -0,0 +1,135 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+* @file latency_histogram.c
+*
+* @brief Lock-free log-linear histogram used for latency instrumentation
+*
+*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "latency_histogram.h"
+
+static int bucket_index(uint64_t value)
+{
+	int msb, shift, index;
+
+	if (value < LATENCY_HISTOGRAM_SUB_BUCKETS)
+	{
+		return (int) value;
+	}
+
+	msb = 63 - __builtin_clzll(value);
+	shift = msb - LATENCY_HISTOGRAM_SUB_BITS;
+	index = (shift + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS +
+	        (int)((value >> shift) - LATENCY_HISTOGRAM_SUB_BUCKETS);
+
+	if (index >= LATENCY_HISTOGRAM_BUCKETS)
+	{
+		index = LATENCY_HISTOGRAM_BUCKETS - 1;
+	}
+
+	return index;
+}
+
+/* Highest value that still lands in the given bucket */
+static uint64_t bucket_upper_bound(int index)
+{
+	int shift;
+	uint64_t sub;
+
+	if (index < LATENCY_HISTOGRAM_SUB_BUCKETS)
+	{
+		return index;
+	}
+
+	shift = index / LATENCY_HISTOGRAM_SUB_BUCKETS - 1;
+	sub = index % LATENCY_HISTOGRAM_SUB_BUCKETS + LATENCY_HISTOGRAM_SUB_BUCKETS;
+
+	return ((sub + 1) << shift) - 1;
+}
+
+void latency_histogram_reset(latency_histogram_t *h)
+{
+	memset(h, 0, sizeof(*h));
+}
+
+void latency_histogram_record(latency_histogram_t *h, int64_t value)
+{
+	uint64_t v = value > 0 ? (uint64_t) value : 0;
+	uint64_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+
+	__atomic_fetch_add(&h->counts[bucket_index(v)], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&h->total, 1, __ATOMIC_RELAXED);
+
+	while (v > max &&
+	        !__atomic_compare_exchange_n(&h->max, &max, v, true, __ATOMIC_RELAXED,
+	                                     __ATOMIC_RELAXED))
+	{
+	}
+}
+
+uint64_t latency_histogram_count(const latency_histogram_t *h)
+{
+	return __atomic_load_n(&h->total, __ATOMIC_RELAXED);
+}
+
+uint64_t latency_histogram_max(const latency_histogram_t *h)
+{
+	return __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+}
+
+/*
+ * Returns the upper bound of the bucket holding the given percentile
+ * (0 - 100), capped to the recorded maximum. Concurrent updates may be
+ * partially visible, which only skews the result by the in-flight samples.
+ */
+uint64_t latency_histogram_percentile(const latency_histogram_t *h,
+                                      double percentile)
+{
+	uint64_t total = latency_histogram_count(h);
+	uint64_t max = latency_histogram_max(h);
+	uint64_t target, seen = 0;
+	int i;
+
+	if (total == 0)
+	{
+		return 0;
+	}
+
+	target = (uint64_t)(percentile / 100.0 * total + 0.5);
+
+	if (target < 1)
+	{
+		target = 1;
+	}
+
+	for (i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+	{
+		seen += __atomic_load_n(&h->counts[i], __ATOMIC_RELAXED);
+
+		if (seen >= target)
+		{
+			uint64_t bound = bucket_upper_bound(i);
+			return bound < max ? bound : max;
+		}
+	}
+
+	return max;
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file latency_histogram.h
+ *
+ * @brief Fixed-size log-linear latency histogram
+ *
+ * Values are bucketed HDR style: each power of two range is split into
+ * LATENCY_HISTOGRAM_SUB_BUCKETS linear buckets, which keeps the relative
+ * error around 6% from single nanoseconds up to minutes. Recording is a
+ * couple of relaxed atomic operations, so a histogram can be updated by the
+ * input path and read from any other thread without locking.
+ */
+
+#ifndef LATENCY_HISTOGRAM_H_
+#define LATENCY_HISTOGRAM_H_
+
+#include <stdint.h>
+
+#define LATENCY_HISTOGRAM_SUB_BITS      4
+#define LATENCY_HISTOGRAM_SUB_BUCKETS   (1 << LATENCY_HISTOGRAM_SUB_BITS)
+/* highest power of two tracked, 2^47 ns is about 39 hours */
+#define LATENCY_HISTOGRAM_MAX_BIT       47
+#define LATENCY_HISTOGRAM_BUCKETS       ((LATENCY_HISTOGRAM_MAX_BIT - \
+                                          LATENCY_HISTOGRAM_SUB_BITS + 2) * \
+                                         LATENCY_HISTOGRAM_SUB_BUCKETS)
+
+typedef struct latency_histogram
+{
+	uint32_t counts[LATENCY_HISTOGRAM_BUCKETS];
+	uint64_t total;     /**< number of recorded values */
+	uint64_t max;       /**< largest recorded value */
+} latency_histogram_t;
+
+void latency_histogram_reset(latency_histogram_t *h);
+void latency_histogram_record(latency_histogram_t *h, int64_t value);
+uint64_t latency_histogram_count(const latency_histogram_t *h);
+uint64_t latency_histogram_max(const latency_histogram_t *h);
+uint64_t latency_histogram_percentile(const latency_histogram_t *h,
+                                      double percentile);
+
+#endif // LATENCY_HISTOGRAM_H_
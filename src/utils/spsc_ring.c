@@ -0,0 +1,106 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+* @file spsc_ring.c
+*
+* @brief Single-producer/single-consumer slot ring
+*
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "spsc_ring.h"
+
+int spsc_ring_init(spsc_ring_t *ring, size_t slotSize, unsigned int numSlots)
+{
+	unsigned int size = 1;
+
+	memset(ring, 0, sizeof(*ring));
+
+	while (size < numSlots)
+	{
+		size <<= 1;
+	}
+
+	/* keep every slot aligned for the structures stored in it */
+	slotSize = (slotSize + sizeof(long long) - 1) & ~(sizeof(long long) - 1);
+
+	ring->slots = calloc(size, slotSize);
+
+	if (!ring->slots)
+	{
+		return -1;
+	}
+
+	ring->slotSize = slotSize;
+	ring->mask = size - 1;
+
+	return 0;
+}
+
+void spsc_ring_free(spsc_ring_t *ring)
+{
+	free(ring->slots);
+	memset(ring, 0, sizeof(*ring));
+}
+
+void *spsc_ring_acquire(spsc_ring_t *ring)
+{
+	unsigned int tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	unsigned int head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	if (tail - head > ring->mask)
+	{
+		return NULL;
+	}
+
+	return ring->slots + (size_t)(tail & ring->mask) * ring->slotSize;
+}
+
+void spsc_ring_publish(spsc_ring_t *ring)
+{
+	unsigned int tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+void *spsc_ring_peek(spsc_ring_t *ring)
+{
+	unsigned int head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	unsigned int tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+	if (head == tail)
+	{
+		return NULL;
+	}
+
+	return ring->slots + (size_t)(head & ring->mask) * ring->slotSize;
+}
+
+void spsc_ring_release(spsc_ring_t *ring)
+{
+	unsigned int head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+unsigned int spsc_ring_count(const spsc_ring_t *ring)
+{
+	return __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) -
+	       __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+}
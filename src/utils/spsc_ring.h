@@ -0,0 +1,60 @@
+// Copyright (c) 2026 agent <agent@local>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file spsc_ring.h
+ *
+ * @brief Lock-free single-producer/single-consumer ring of fixed-size slots
+ *
+ * The producer fills the slot returned by spsc_ring_acquire() in place and
+ * makes it visible with spsc_ring_publish(); the consumer reads the slot
+ * returned by spsc_ring_peek() in place and hands it back with
+ * spsc_ring_release(). Exactly one thread may act as producer and one as
+ * consumer; the head and tail indices live on separate cache lines so the
+ * two sides do not bounce a line between them on every frame.
+ */
+
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+#include <stddef.h>
+
+#define SPSC_RING_CACHE_LINE    64
+
+typedef struct spsc_ring
+{
+	unsigned char *slots;
+	size_t slotSize;
+	unsigned int mask;      /**< number of slots - 1, a power of two */
+	unsigned int head __attribute__((aligned(SPSC_RING_CACHE_LINE)));  /**< written by the consumer */
+	unsigned int tail __attribute__((aligned(SPSC_RING_CACHE_LINE)));  /**< written by the producer */
+} spsc_ring_t;
+
+/* numSlots is rounded up to a power of two; returns -1 if out of memory */
+int spsc_ring_init(spsc_ring_t *ring, size_t slotSize, unsigned int numSlots);
+void spsc_ring_free(spsc_ring_t *ring);
+
+/* Producer side: next free slot or NULL if the ring is full */
+void *spsc_ring_acquire(spsc_ring_t *ring);
+void spsc_ring_publish(spsc_ring_t *ring);
+
+/* Consumer side: oldest published slot or NULL if the ring is empty */
+void *spsc_ring_peek(spsc_ring_t *ring);
+void spsc_ring_release(spsc_ring_t *ring);
+
+unsigned int spsc_ring_count(const spsc_ring_t *ring);
+
+#endif // SPSC_RING_H_